@@ -16,21 +16,60 @@
 
 /* Private define ------------------------------------------------------------*/
 #define DP83822_MAX_DEV_ADDR   ((uint32_t)31U)
+#define DP83822_MAX_REG_ADDR   ((uint32_t)31U)
+#define DP83822_IS_LINK_UP(State) ((State) >= DP83822_STATUS_100MBITS_FULLDUPLEX && (State) <= DP83822_STATUS_10MBITS_HALFDUPLEX)
+
+/* Private variables ---------------------------------------------------------*/
+/* Register address of each DP83822_SHADOW_xxx entry */
+static const uint16_t DP83822_ShadowRegs[DP83822_SHADOW_NB] = { DP83822_BMCR, DP83822_PHYSCR };
 
 /* Private function prototypes -----------------------------------------------*/
-static int32_t DP83822_ReadReg(uint32_t PhyAddr, uint32_t RegAddr, uint32_t *RegVal);
-static int32_t DP83822_WriteReg(uint32_t PhyAddr, uint32_t RegAddr, uint32_t RegVal);
+static uint32_t DP83822_ProbeAddr(dp83822_Object_t *pObj, uint32_t Addr);
+static int32_t DP83822_DecodeLinkState(uint32_t bsr, uint32_t bcr, uint32_t physts);
+static int32_t DP83822_DecodePhysts(uint32_t physts);
+static void DP83822_TrackLinkMode(dp83822_Object_t *pObj, uint32_t bcr);
+static int32_t DP83822_SetupExt(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint32_t Function);
+static int32_t DP83822_ReadRegs(dp83822_Object_t *pObj, dp83822_RegOp_t *pOps, uint32_t Count);
+static int32_t DP83822_WriteRegs(dp83822_Object_t *pObj, const dp83822_RegOp_t *pOps, uint32_t Count);
+static int32_t DP83822_BusRead(dp83822_Object_t *pObj, uint32_t Addr, uint32_t RegAddr, uint32_t *pVal);
+static int32_t DP83822_BusWrite(dp83822_Object_t *pObj, uint32_t Addr, uint32_t RegAddr, uint32_t Val);
+static uint32_t DP83822_PeekCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t *pVal);
+static void DP83822_CacheCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t Val);
+static int32_t DP83822_ReadCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t *pVal);
+static int32_t DP83822_WriteCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t Val);
+static int32_t DP83822_LatchIT(dp83822_Object_t *pObj, uint32_t Interrupt);
+static int32_t DP83822_WriteITMask(dp83822_Object_t *pObj, uint32_t ITEnabled, uint32_t Changed);
+static int32_t DP83822_ReadLinkState(dp83822_Object_t *pObj);
+static int32_t DP83822_ForcedCtrl(uint32_t LinkState, uint32_t *pBcr);
+static int32_t DP83822_WriteFastTimers(dp83822_Object_t *pObj);
+static int32_t DP83822_WriteFastLinkDown(dp83822_Object_t *pObj);
+static void DP83822_CheckPreamble(dp83822_Object_t *pObj, uint32_t bsr);
+static void DP83822_LogEvent(dp83822_Object_t *pObj, uint32_t Type, int32_t LinkState, uint32_t Interrupt);
+static void DP83822_LogLinkState(dp83822_Object_t *pObj, int32_t LinkState);
+static int32_t DP83822_FilterLinkState(dp83822_Object_t *pObj, int32_t LinkState);
+static void DP83822_SelfTestRate(dp83822_Object_t *pObj, uint32_t ElapsedMs);
+static int32_t DP83822_StopSelfTest(dp83822_Object_t *pObj);
+static void DP83822_DecodeCablePair(const uint16_t *pRegs, uint32_t Pair, dp83822_CablePair_t *pResult);
+static uint32_t DP83822_ProfileValid(const dp83822_ProfileEntry_t *pEntries, uint32_t Count);
+static int32_t DP83822_RunProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count,
+                                  uint32_t Write, dp83822_ProfileResult_t *pResult);
+static void DP83822_ProfileMismatch(dp83822_ProfileResult_t *pResult, uint32_t Idx);
+static int32_t DP83822_WriteEee(dp83822_Object_t *pObj);
+static void DP83822_CountLpi(uint32_t Prev, uint32_t Status, uint32_t Ind, uint32_t Rcvd, uint32_t ElapsedMs,
+                             uint32_t *pEntries, uint32_t *pExits, uint32_t *pLpiMs);
 
 /**
   * @brief  Register IO functions to component object
   * @param  pObj: device object of dp83822_Object_t.
   * @param  ioctx: holds device IO functions.
   * @retval DP83822_STATUS_OK if OK
-  *         DP83822_STATUS_ERROR if missing mandatory function
+  *         DP83822_STATUS_ERROR if missing mandatory function, or only one
+  *         of Lock/Unlock is given
   */
 int32_t DP83822_RegisterBusIO(dp83822_Object_t *pObj, dp83822_IOCtx_t *ioctx)
 {
-  if(!pObj || !ioctx->ReadReg || !ioctx->WriteReg || !ioctx->GetTick)
+  if(!pObj || !ioctx->ReadReg || !ioctx->WriteReg || !ioctx->GetTick ||
+     (!ioctx->Lock != !ioctx->Unlock))
   {
     return DP83822_STATUS_ERROR;
   }
@@ -40,93 +79,372 @@ int32_t DP83822_RegisterBusIO(dp83822_Object_t *pObj, dp83822_IOCtx_t *ioctx)
   pObj->IO.ReadReg  = ioctx->ReadReg;
   pObj->IO.WriteReg = ioctx->WriteReg;
   pObj->IO.GetTick  = ioctx->GetTick;
+  pObj->IO.ReadBatch  = ioctx->ReadBatch;
+  pObj->IO.WriteBatch = ioctx->WriteBatch;
+  pObj->IO.Lock       = ioctx->Lock;
+  pObj->IO.Unlock     = ioctx->Unlock;
+  pObj->IO.SetPreamble = ioctx->SetPreamble;
 
   return DP83822_STATUS_OK;
 }
 
 /**
-  * @brief  Initialize the DP83822 and configure hardware resources
+  * @brief  Enumerate every DP83822 on an MDIO bus in a single pass.
+  *         PHYIDR1 is read once per address, PHYIDR2 only where the OUI
+  *         matches. Assign the returned addresses to the AddrHint of each
+  *         PHY object so their init finds the PHY with one probe.
+  * @param  ioctx: IO functions of the bus, Lock/Unlock are held for the scan.
+  * @param  pAddr: array to hold the addresses found, in ascending order.
+  * @param  MaxCount: size of pAddr.
+  * @param  pCount: pointer to hold the number of PHYs found, may exceed
+  *         MaxCount when pAddr is too small.
+  * @retval DP83822_STATUS_OK if at least one DP83822 was found
+  *         DP83822_STATUS_ADDRESS_ERROR if no DP83822 answered
+  *         DP83822_STATUS_ERROR if missing mandatory function
+  */
+int32_t DP83822_ScanBus(dp83822_IOCtx_t *ioctx, uint32_t *pAddr, uint32_t MaxCount, uint32_t *pCount)
+{
+  uint32_t addr = 0, reg1 = 0, reg2 = 0, count = 0;
+
+  if(!ioctx || !ioctx->ReadReg || !pCount)
+  {
+    return DP83822_STATUS_ERROR;
+  }
+
+  if(ioctx->Lock && ioctx->Lock() < 0)
+  {
+    return DP83822_STATUS_ERROR;
+  }
+
+  for(addr = 0; addr <= DP83822_MAX_DEV_ADDR; addr++)
+  {
+    if(ioctx->ReadReg(addr, DP83822_PHYI1R, &reg1) < 0 || reg1 != DP83822_PHYI1R_OUI_3_18)
+      continue;
+    if(ioctx->ReadReg(addr, DP83822_PHYI2R, &reg2) < 0)
+      continue;
+
+    /* Match OUI bits [24:19] and model number, any revision */
+    if((reg2 & (DP83822_PHYI2R_OUI_19_24 | DP83822_PHYI2R_MODEL_NBR)) == DP83822_PHYI2R_ID)
+    {
+      if(count < MaxCount)
+      {
+        pAddr[count] = addr;
+      }
+      count++;
+    }
+  }
+
+  if(ioctx->Unlock)
+  {
+    ioctx->Unlock();
+  }
+
+  *pCount = count;
+
+  return (count > 0) ? DP83822_STATUS_OK : DP83822_STATUS_ADDRESS_ERROR;
+}
+
+/**
+  * @brief  Initialize the DP83822 and configure hardware resources.
+  *         Blocking wrapper around DP83822_StartInit() / DP83822_PollInit(),
+  *         every wait is bounded by a GetTick deadline.
   * @param  pObj: device object dp83822_Object_t.
-  * @retval DP83822_STATUS_OK if OK
+  * @retval DP83822_STATUS_OK if OK (link may still be down)
   *         DP83822_STATUS_ADDRESS_ERROR if cannot find device address
   *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_RESET_TIMEOUT if cannot perform a software reset
   */
 int32_t DP83822_Init(dp83822_Object_t *pObj)
 {
-  uint32_t reg = 0, addr = 0;
   int32_t status = DP83822_STATUS_OK;
 
   if(pObj->Is_Initialized == 0)
   {
-    if(pObj->IO.Init)
+    status = DP83822_StartInit(pObj);
+
+    while(status == DP83822_STATUS_OK && pObj->InitState != DP83822_INIT_STATE_DONE)
     {
-      /* GPIO/clock init */
-      pObj->IO.Init();
-    }
+      status = DP83822_PollInit(pObj);
 
-    pObj->DevAddr = DP83822_MAX_DEV_ADDR + 1;
+      if(status == DP83822_STATUS_BUSY)
+      {
+        status = DP83822_STATUS_OK;
+      }
+    }
 
-    /* Detect PHY address via SMR */
-    for(addr = 0; addr <= DP83822_MAX_DEV_ADDR; addr++)
+    if(status == DP83822_STATUS_LINK_DOWN)
     {
-        uint32_t reg1 = 0, reg2 = 0;
-        if(pObj->IO.ReadReg(addr, DP83822_PHYI1R, &reg1) < 0)
-            continue;
-        if(pObj->IO.ReadReg(addr, DP83822_PHYI2R, &reg2) < 0)
-            continue;
-        if(reg1 != 0xFFFF && reg2 != 0xFFFF)
-		{
-            pObj->DevAddr = addr;
-            status = DP83822_STATUS_OK;
-            break;
-		}
-        else
-        {
-        	continue;
-        }
+      /* No cable: leave link bring-up to the network stack */
+      status = DP83822_STATUS_OK;
     }
+  }
+  return status;
+}
+
+/**
+  * @brief  Start a non-blocking initialization of the DP83822.
+  *         Detects the PHY address and issues a soft reset, the remaining
+  *         phases are run by DP83822_PollInit(). pObj->AddrHint is probed
+  *         first with a single PHYIDR1 read, set it to the strap address or
+  *         to a DevAddr retained from a previous boot to skip the bus scan.
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ADDRESS_ERROR if cannot find device address
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_StartInit(dp83822_Object_t *pObj)
+{
+  uint32_t addr = 0;
+
+  if(pObj->Is_Initialized)
+  {
+    return DP83822_STATUS_OK;
+  }
+
+  pObj->InitState = DP83822_INIT_STATE_IDLE;
+
+  if(pObj->IO.Init)
+  {
+    /* GPIO/clock init */
+    pObj->IO.Init();
+  }
+
+  pObj->DevAddr = DP83822_MAX_DEV_ADDR + 1;
+  pObj->ProbeCount = 0;
 
-    if (pObj->DevAddr > DP83822_MAX_DEV_ADDR)
+  /* Probe the hinted (strap or previously discovered) address first */
+  if(pObj->AddrHint <= DP83822_MAX_DEV_ADDR && DP83822_ProbeAddr(pObj, pObj->AddrHint))
+  {
+    pObj->DevAddr = pObj->AddrHint;
+  }
+  else
+  {
+    /* Fall back to a full scan of the MDIO bus */
+    for(addr = 0; addr <= DP83822_MAX_DEV_ADDR; addr++)
     {
-        return DP83822_STATUS_ADDRESS_ERROR;
+      if(addr != pObj->AddrHint && DP83822_ProbeAddr(pObj, addr))
+      {
+        pObj->DevAddr = addr;
+        break;
+      }
     }
+  }
 
-    if(status == DP83822_STATUS_OK)
-    {
-      /* Verify PHY ID */
-    	uint32_t reg1 = 0, reg2 = 0;
-    	pObj->IO.ReadReg(pObj->DevAddr, DP83822_PHYI1R, &reg1);
-    	pObj->IO.ReadReg(pObj->DevAddr, DP83822_PHYI2R, &reg2);
+  if(pObj->DevAddr > DP83822_MAX_DEV_ADDR)
+  {
+    return DP83822_STATUS_ADDRESS_ERROR;
+  }
+
+  /* Soft reset clears the interrupt and Wake-on-LAN configuration */
+  pObj->ITEnabled = 0;
+  pObj->ITPending = 0;
+  pObj->PhystsLatch = 0;
+  pObj->SelfTest.State = DP83822_BIST_STATE_IDLE;
+  pObj->CableDiagRunning = 0;
+  pObj->Debounce.Pending = 0;
+  pObj->Debounce.RawUp = 0;
+  pObj->LpiStatus = 0;
+  pObj->WolConfig = 0;
+
+  /* Soft reset, completion is polled by DP83822_PollInit() */
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, DP83822_BMCR_SOFT_RESET) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  /* The link drops with the reset, the next link up is logged even if it was not polled down */
+  DP83822_LogEvent(pObj, DP83822_EVENT_RESET, 0, 0);
+  pObj->Events.LastLinkState = DP83822_STATUS_LINK_DOWN;
+
+  pObj->InitTick  = (uint32_t)pObj->IO.GetTick();
+  pObj->InitState = DP83822_INIT_STATE_RESET;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Advance the initialization started by DP83822_StartInit().
+  *         Performs one MDIO status read (plus the writes of a phase change)
+  *         per call and never spins, call it from a timer or idle loop.
+  *         With DP83822_SetFastStart() the link is first forced to the known
+  *         speed/duplex and autonegotiation only runs if that times out.
+  *         When the IO context provides SetPreamble and BMSR reports MF
+  *         preamble suppression, the IO layer is told to drop the preamble.
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval DP83822_STATUS_BUSY if initialization is still in progress
+  *         DP83822_STATUS_OK if initialization is complete and link is up
+  *         DP83822_STATUS_LINK_DOWN if initialization is complete but no link
+  *         appeared within DP83822_LINK_TIMEOUT_VALUE
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_RESET_TIMEOUT if soft reset or autonegotiation
+  *         enable did not complete within DP83822_TIMEOUT_VALUE
+  *         DP83822_STATUS_ERROR if initialization was not started
+  */
+int32_t DP83822_PollInit(dp83822_Object_t *pObj)
+{
+  int32_t status;
+  uint32_t reg = 0;
+  uint32_t elapsed = (uint32_t)pObj->IO.GetTick() - pObj->InitTick;
 
-    	/* Verify OUI bits */
-    	if (reg1 != DP83822_PHYI1R_OUI_3_18)
-    	    return DP83822_STATUS_ADDRESS_ERROR;
+  switch(pObj->InitState)
+  {
+    case DP83822_INIT_STATE_RESET:
+      if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_BMCR, &reg) < 0)
+        return DP83822_STATUS_READ_ERROR;
+
+      if(reg & DP83822_BMCR_SOFT_RESET)
+      {
+        if(elapsed > DP83822_TIMEOUT_VALUE)
+        {
+          pObj->InitState = DP83822_INIT_STATE_ERROR;
+          return DP83822_STATUS_RESET_TIMEOUT;
+        }
+        return DP83822_STATUS_BUSY;
+      }
+
+      /* Fast timers, fast link down, advertisements and profile are lost with the reset,
+         restore them before the link is brought up */
+      if(pObj->FastTimers && DP83822_WriteFastTimers(pObj) < 0)
+        return DP83822_STATUS_WRITE_ERROR;
+      if(pObj->FastLinkDown && (status = DP83822_WriteFastLinkDown(pObj)) < 0)
+        return status;
+      if(pObj->Advertise &&
+         DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_ANAR, pObj->Advertise | DP83822_ANAR_SELECTOR_IEEE802_3) < 0)
+        return DP83822_STATUS_WRITE_ERROR;
+      if(pObj->EeeMode != DP83822_EEE_DEFAULT && (status = DP83822_WriteEee(pObj)) < 0)
+        return status;
+      if(pObj->pProfile &&
+         (status = DP83822_ApplyProfile(pObj, pObj->pProfile, pObj->ProfileCount, 0)) < 0)
+        return status;
 
-      /* Soft reset */
-      pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, DP83822_BMCR_SOFT_RESET);
-      do
+      if(pObj->FastStartState)
       {
-        pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &reg);
-      } while(reg & DP83822_BMCR_SOFT_RESET);
+        /* Try the known speed/duplex first, the PHY is usable from here on */
+        DP83822_ForcedCtrl(pObj->FastStartState, &reg);
+        if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, reg) < 0)
+          return DP83822_STATUS_WRITE_ERROR;
+
+        pObj->Is_Initialized = 1;
+        pObj->InitTick  = (uint32_t)pObj->IO.GetTick();
+        pObj->InitState = DP83822_INIT_STATE_FAST_START;
+        return DP83822_STATUS_BUSY;
+      }
 
       /* Enable and restart autonegotiation */
-      pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, DP83822_BMCR_AUTONEGO_EN | DP83822_BMCR_RESTART_AUTONEGO);
-      do
+      if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, DP83822_BMCR_AUTONEGO_EN | DP83822_BMCR_RESTART_AUTONEGO) < 0)
+        return DP83822_STATUS_WRITE_ERROR;
+
+      DP83822_LogEvent(pObj, DP83822_EVENT_AUTONEGO_START, 0, 0);
+
+      pObj->InitTick  = (uint32_t)pObj->IO.GetTick();
+      pObj->InitState = DP83822_INIT_STATE_AUTONEGO;
+      return DP83822_STATUS_BUSY;
+
+    case DP83822_INIT_STATE_FAST_START:
+      if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_BMSR, &reg) < 0)
+        return DP83822_STATUS_READ_ERROR;
+
+      DP83822_CheckPreamble(pObj, reg);
+
+      if(reg & DP83822_BMSR_LINK_STATUS)
       {
-        pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &reg);
-      } while(!(reg & DP83822_BMCR_AUTONEGO_EN));
+        pObj->InitState = DP83822_INIT_STATE_DONE;
+        return DP83822_STATUS_OK;
+      }
+
+      if(elapsed <= (pObj->FastStartTimeout ? pObj->FastStartTimeout : DP83822_FAST_START_TIMEOUT_VALUE))
+        return DP83822_STATUS_BUSY;
+
+      /* No link at the forced speed/duplex, fall back to autonegotiation */
+      if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, DP83822_BMCR_AUTONEGO_EN | DP83822_BMCR_RESTART_AUTONEGO) < 0)
+        return DP83822_STATUS_WRITE_ERROR;
+
+      DP83822_LogEvent(pObj, DP83822_EVENT_AUTONEGO_START, 0, 0);
+
+      pObj->InitTick  = (uint32_t)pObj->IO.GetTick();
+      pObj->InitState = DP83822_INIT_STATE_AUTONEGO;
+      return DP83822_STATUS_BUSY;
 
-      /* Wait link up */
-      do
+    case DP83822_INIT_STATE_AUTONEGO:
+      if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_BMCR, &reg) < 0)
+        return DP83822_STATUS_READ_ERROR;
+
+      if(!(reg & DP83822_BMCR_AUTONEGO_EN))
       {
-        pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMSR, &reg);
-      } while(!(reg & DP83822_BMSR_LINK_STATUS));
-      pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMSR, &reg);
+        if(elapsed > DP83822_TIMEOUT_VALUE)
+        {
+          pObj->InitState = DP83822_INIT_STATE_ERROR;
+          return DP83822_STATUS_RESET_TIMEOUT;
+        }
+        return DP83822_STATUS_BUSY;
+      }
 
+      /* PHY is usable from here on, link comes up in the background */
       pObj->Is_Initialized = 1;
-    }
+      pObj->InitTick  = (uint32_t)pObj->IO.GetTick();
+      pObj->InitState = DP83822_INIT_STATE_LINK_WAIT;
+      return DP83822_STATUS_BUSY;
+
+    case DP83822_INIT_STATE_LINK_WAIT:
+      if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_BMSR, &reg) < 0)
+        return DP83822_STATUS_READ_ERROR;
+
+      DP83822_CheckPreamble(pObj, reg);
+
+      if(reg & DP83822_BMSR_LINK_STATUS)
+      {
+        pObj->InitState = DP83822_INIT_STATE_DONE;
+        return DP83822_STATUS_OK;
+      }
+
+      if(elapsed > DP83822_LINK_TIMEOUT_VALUE)
+      {
+        pObj->InitState = DP83822_INIT_STATE_DONE;
+        return DP83822_STATUS_LINK_DOWN;
+      }
+      return DP83822_STATUS_BUSY;
+
+    case DP83822_INIT_STATE_DONE:
+      return DP83822_STATUS_OK;
+
+    case DP83822_INIT_STATE_ERROR:
+      return DP83822_STATUS_RESET_TIMEOUT;
+
+    default:
+      return DP83822_STATUS_ERROR;
   }
-  return status;
+}
+
+/**
+  * @brief  Get the current phase of the initialization state machine.
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval DP83822_INIT_STATE_xxx
+  */
+uint32_t DP83822_GetInitState(dp83822_Object_t *pObj)
+{
+  return pObj->InitState;
+}
+
+/**
+  * @brief  Select the control register shadow mode. The shadow is emptied
+  *         and refilled by the next access to each register.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Mode: DP83822_SHADOW_DISABLED, DP83822_SHADOW_ENABLED or
+  *         DP83822_SHADOW_VALIDATE (read-through, counts cache mismatches)
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if Mode is invalid
+  */
+int32_t DP83822_SetShadowMode(dp83822_Object_t *pObj, uint32_t Mode)
+{
+  if(Mode > DP83822_SHADOW_VALIDATE)
+  {
+    return DP83822_STATUS_ERROR;
+  }
+
+  pObj->Shadow.Mode  = Mode;
+  pObj->Shadow.Valid = 0;
+
+  return DP83822_STATUS_OK;
 }
 
 /**
@@ -138,11 +456,19 @@ int32_t DP83822_DeInit(dp83822_Object_t *pObj)
 {
   if(pObj->Is_Initialized)
   {
+    if(pObj->PreambleSuppressed)
+    {
+      pObj->IO.SetPreamble(pObj->DevAddr, 0);
+      pObj->PreambleSuppressed = 0;
+    }
     if(pObj->IO.DeInit)
     {
       pObj->IO.DeInit();
     }
     pObj->Is_Initialized = 0;
+    pObj->InitState = DP83822_INIT_STATE_IDLE;
+    pObj->Shadow.Valid = 0;
+    pObj->LinkMode = DP83822_LINK_MODE_UNKNOWN;
   }
   return DP83822_STATUS_OK;
 }
@@ -153,10 +479,10 @@ int32_t DP83822_DeInit(dp83822_Object_t *pObj)
 int32_t DP83822_DisablePowerDownMode(dp83822_Object_t *pObj)
 {
   uint32_t val = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &val) < 0)
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &val) < 0)
     return DP83822_STATUS_READ_ERROR;
   val &= ~DP83822_BMCR_POWER_DOWN;
-  if(pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, val) < 0)
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, val) < 0)
     return DP83822_STATUS_WRITE_ERROR;
   return DP83822_STATUS_OK;
 }
@@ -167,10 +493,10 @@ int32_t DP83822_DisablePowerDownMode(dp83822_Object_t *pObj)
 int32_t DP83822_EnablePowerDownMode(dp83822_Object_t *pObj)
 {
   uint32_t val = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &val) < 0)
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &val) < 0)
     return DP83822_STATUS_READ_ERROR;
   val |= DP83822_BMCR_POWER_DOWN;
-  if(pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, val) < 0)
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, val) < 0)
     return DP83822_STATUS_WRITE_ERROR;
   return DP83822_STATUS_OK;
 }
@@ -181,64 +507,211 @@ int32_t DP83822_EnablePowerDownMode(dp83822_Object_t *pObj)
 int32_t DP83822_StartAutoNego(dp83822_Object_t *pObj)
 {
   uint32_t val = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &val) < 0)
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &val) < 0)
     return DP83822_STATUS_READ_ERROR;
   val |= DP83822_BMCR_AUTONEGO_EN;
-  if(pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, val) < 0)
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, val) < 0)
     return DP83822_STATUS_WRITE_ERROR;
+  DP83822_LogEvent(pObj, DP83822_EVENT_AUTONEGO_START, 0, 0);
   return DP83822_STATUS_OK;
 }
 
 /**
-  * @brief  Get link state
+  * @brief  Get link state. With a ReadBatch callback BMSR, PHYSTS and BMCR
+  *         (unless shadowed) are fetched in a single MDIO job, otherwise the
+  *         registers are read one by one and only as far as needed. Changes
+  *         against the previous poll are recorded in the event log. With
+  *         DP83822_SetDebounce() the caller sees the debounced state while
+  *         the event log keeps the raw changes.
   */
 int32_t DP83822_GetLinkState(dp83822_Object_t *pObj)
 {
-  uint32_t bsr = 0, bcr = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMSR, &bsr) < 0)
+  int32_t state = DP83822_ReadLinkState(pObj);
+
+  DP83822_LogLinkState(pObj, state);
+  return DP83822_FilterLinkState(pObj, state);
+}
+
+/**
+  * @brief  Debounce the link reported by DP83822_GetLinkState(). A link up
+  *         is reported once it held for UpMs, a link down once it held for
+  *         DownMs, a change that reverts earlier is not reported at all.
+  *         Speed/duplex changes of a link that stays up pass at once. When
+  *         FlapLimit raw drops fall within DP83822_FLAP_WINDOW_MS the link
+  *         is reported down and must then hold up for HoldDownMs. Windows
+  *         are measured between polls, poll at least as often as the
+  *         shortest window. All zero disables the filter.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  UpMs: link up debounce window in ms
+  * @param  DownMs: link down debounce window in ms
+  * @param  FlapLimit: raw drops that start a hold-down, 0 for none
+  * @param  HoldDownMs: link up window during a hold-down, at least UpMs
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if HoldDownMs is below UpMs with a FlapLimit
+  */
+int32_t DP83822_SetDebounce(dp83822_Object_t *pObj, uint32_t UpMs, uint32_t DownMs, uint32_t FlapLimit, uint32_t HoldDownMs)
+{
+  dp83822_Debounce_t *db = &pObj->Debounce;
+
+  if(FlapLimit != 0 && HoldDownMs < UpMs)
+    return DP83822_STATUS_ERROR;
+
+  db->UpMs       = UpMs;
+  db->DownMs     = DownMs;
+  db->FlapLimit  = FlapLimit;
+  db->HoldDownMs = HoldDownMs;
+  db->Pending    = 0;
+  db->HoldDown   = 0;
+  db->Flaps      = 0;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Get a consolidated link status from a single PHYSTS read. BMCR
+  *         is only read when the speed/duplex selection mode is not known
+  *         from an earlier BMCR access. Unlike GetLinkState() the link bit
+  *         is the live PHYSTS value, not the latched-low BMSR one. The
+  *         clear-on-read false carrier and receive error latches include
+  *         those a link poll read since the last report.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pStatus: pointer to hold the decoded status
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_GetStatus(dp83822_Object_t *pObj, dp83822_Status_t *pStatus)
+{
+  uint32_t physts = 0, bcr = 0;
+
+  if(pObj->LinkMode == DP83822_LINK_MODE_UNKNOWN)
+  {
+    if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
+      return DP83822_STATUS_READ_ERROR;
+  }
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_PHYSTS, &physts) < 0)
     return DP83822_STATUS_READ_ERROR;
-  if(!(bsr & DP83822_BMSR_LINK_STATUS))
-    return DP83822_STATUS_LINK_DOWN;
 
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &bcr) < 0)
+  /* Include the latches a link poll read since the last report */
+  physts |= pObj->PhystsLatch;
+  pObj->PhystsLatch = 0;
+
+  pStatus->Physts           = (uint16_t)physts;
+  pStatus->Link             = (physts & DP83822_PHYSTS_LINK_STATUS) != 0;
+  pStatus->Speed100         = (physts & DP83822_PHYSTS_SPEED_MASK) == 0;
+  pStatus->FullDuplex       = (physts & DP83822_PHYSTS_DUPLEX_MASK) != 0;
+  pStatus->ForcedMode       = (pObj->LinkMode == DP83822_LINK_MODE_FORCED);
+  pStatus->AutoNegoDone     = (physts & DP83822_PHYSTS_AUTONEGO_DONE) != 0;
+  pStatus->Mdix             = (physts & DP83822_PHYSTS_MDIX_MODE) != 0;
+  pStatus->PolarityInverted = (physts & DP83822_PHYSTS_POLARITY) != 0;
+  pStatus->RemoteFault      = (physts & DP83822_PHYSTS_REMOTE_FAULT) != 0;
+  pStatus->Jabber           = (physts & DP83822_PHYSTS_JABBER_DETECT) != 0;
+  pStatus->FalseCarrier     = (physts & DP83822_PHYSTS_FALSE_CARRIER) != 0;
+  pStatus->RxError          = (physts & DP83822_PHYSTS_RX_ERROR_LATCH) != 0;
+  pStatus->SignalDetect     = (physts & DP83822_PHYSTS_SIGNAL_DETECT) != 0;
+  pStatus->DescramblerLock  = (physts & DP83822_PHYSTS_DESCRAMBLER_LOCK) != 0;
+
+  if(!pStatus->Link)
+    pStatus->LinkState = DP83822_STATUS_LINK_DOWN;
+  else if(!pStatus->ForcedMode && !pStatus->AutoNegoDone)
+    pStatus->LinkState = DP83822_STATUS_AUTONEGO_NOTDONE;
+  else
+    pStatus->LinkState = DP83822_DecodePhysts(physts);
+
+  DP83822_LogLinkState(pObj, pStatus->LinkState);
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Sample the link with DP83822_GetStatus() and publish it to the
+  *         lock-free readers. Call it from exactly one context, the link
+  *         poller or the thread the INTn interrupt defers to. The generation
+  *         only moves when link, speed, duplex or PHYSTS state bits change,
+  *         not for the clear-on-read error latches.
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_PublishStatus(dp83822_Object_t *pObj)
+{
+  dp83822_LinkPub_t *pub = &pObj->LinkPub;
+  dp83822_Status_t status;
+  uint32_t changed;
+
+  if(DP83822_GetStatus(pObj, &status) < 0)
     return DP83822_STATUS_READ_ERROR;
 
-  if((bcr & DP83822_BMCR_AUTONEGO_EN) == 0)
+  changed = (status.LinkState != pub->Status.LinkState) ||
+            (status.ForcedMode != pub->Status.ForcedMode) ||
+            ((status.Physts ^ pub->Status.Physts) & DP83822_PHYSTS_STATE_MASK);
+
+  pub->Sequence++;
+  DP83822_MEMORY_BARRIER();
+
+  pub->Status = status;
+  pub->Tick   = (uint32_t)pObj->IO.GetTick();
+  if(changed)
   {
-    /* Forced mode */
-    if((bcr & DP83822_BMCR_SPEED_SELECT) && (bcr & DP83822_BMCR_DUPLEX_MODE))
-      return DP83822_STATUS_100MBITS_FULLDUPLEX;
-    else if(bcr & DP83822_BMCR_SPEED_SELECT)
-      return DP83822_STATUS_100MBITS_HALFDUPLEX;
-    else if(bcr & DP83822_BMCR_DUPLEX_MODE)
-      return DP83822_STATUS_10MBITS_FULLDUPLEX;
-    else
-      return DP83822_STATUS_10MBITS_HALFDUPLEX;
+    pub->Generation++;
   }
-  else
+
+  DP83822_MEMORY_BARRIER();
+  pub->Sequence++;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Read the published link status without MDIO access or locks.
+  *         Safe from any thread or interrupt, a read racing the writer is
+  *         retried up to DP83822_PUB_READ_RETRIES times.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pStatus: pointer to hold the status, may be NULL
+  * @param  pGeneration: pointer to hold the generation, may be NULL
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_BUSY if the writer kept updating, e.g. when it was
+  *         preempted mid-update by the reading interrupt
+  */
+int32_t DP83822_ReadPublishedStatus(dp83822_Object_t *pObj, dp83822_Status_t *pStatus, uint32_t *pGeneration)
+{
+  dp83822_LinkPub_t *pub = &pObj->LinkPub;
+  dp83822_Status_t status;
+  uint32_t seq, generation, retry;
+
+  for(retry = 0; retry < DP83822_PUB_READ_RETRIES; retry++)
   {
-	    /* Auto-negotiated, read PHYSTS */
-	    if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_PHYSTS, &bsr) < 0)
-	      return DP83822_STATUS_READ_ERROR;
-	    if(!(bsr & DP83822_PHYSTS_AUTONEGO_DONE))
-	      return DP83822_STATUS_AUTONEGO_NOTDONE;
+    seq = pub->Sequence;
+    DP83822_MEMORY_BARRIER();
 
-	    /* decode speed/duplex from bits [2:1] of PHYSTS */
-	    switch (bsr & (DP83822_PHYSTS_SPEED_MASK | DP83822_PHYSTS_DUPLEX_MASK))
-	    {
+    if(seq & 1U)
+      continue;
 
-	      case 0U:
-	        return DP83822_STATUS_100MBITS_HALFDUPLEX;
-	      case DP83822_PHYSTS_DUPLEX_MASK:
-	        return DP83822_STATUS_100MBITS_FULLDUPLEX;
-	      case DP83822_PHYSTS_SPEED_MASK:
-	        return DP83822_STATUS_10MBITS_HALFDUPLEX;
-	      case (DP83822_PHYSTS_SPEED_MASK | DP83822_PHYSTS_DUPLEX_MASK):
-	        return DP83822_STATUS_10MBITS_FULLDUPLEX;
-	      default:
-	        return DP83822_STATUS_ERROR;
-	    }
+    status     = pub->Status;
+    generation = pub->Generation;
+
+    DP83822_MEMORY_BARRIER();
+    if(pub->Sequence == seq)
+    {
+      if(pStatus)
+        *pStatus = status;
+      if(pGeneration)
+        *pGeneration = generation;
+      return DP83822_STATUS_OK;
+    }
   }
+
+  return DP83822_STATUS_BUSY;
+}
+
+/**
+  * @brief  Get the generation of the published link status, a single word
+  *         read consumers can compare to detect a change.
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval Generation counter
+  */
+uint32_t DP83822_GetPublishedGeneration(dp83822_Object_t *pObj)
+{
+  return pObj->LinkPub.Generation;
 }
 
 /**
@@ -247,26 +720,15 @@ int32_t DP83822_GetLinkState(dp83822_Object_t *pObj)
 int32_t DP83822_SetLinkState(dp83822_Object_t *pObj, uint32_t LinkState)
 {
   uint32_t bcr = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &bcr) < 0)
+  uint32_t forced = 0;
+  if(DP83822_ForcedCtrl(LinkState, &forced) < 0)
+    return DP83822_STATUS_ERROR;
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
     return DP83822_STATUS_READ_ERROR;
   bcr &= ~(DP83822_BMCR_AUTONEGO_EN | DP83822_BMCR_SPEED_SELECT | DP83822_BMCR_DUPLEX_MODE);
+  bcr |= forced;
 
-  switch(LinkState)
-  {
-    case DP83822_STATUS_100MBITS_FULLDUPLEX:
-      bcr |= (DP83822_BMCR_SPEED_SELECT | DP83822_BMCR_DUPLEX_MODE);
-      break;
-    case DP83822_STATUS_100MBITS_HALFDUPLEX:
-      bcr |= DP83822_BMCR_SPEED_SELECT;
-      break;
-    case DP83822_STATUS_10MBITS_FULLDUPLEX:
-      bcr |= DP83822_BMCR_DUPLEX_MODE;
-      break;
-    default:
-      return DP83822_STATUS_ERROR;
-  }
-
-  if(pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, bcr) < 0)
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, bcr) < 0)
     return DP83822_STATUS_WRITE_ERROR;
 
   return DP83822_STATUS_OK;
@@ -278,10 +740,10 @@ int32_t DP83822_SetLinkState(dp83822_Object_t *pObj, uint32_t LinkState)
 int32_t DP83822_EnableLoopbackMode(dp83822_Object_t *pObj)
 {
   uint32_t bcr = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &bcr) < 0)
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
     return DP83822_STATUS_READ_ERROR;
   bcr |= DP83822_BMCR_LOOPBACK;
-  if(pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, bcr) < 0)
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, bcr) < 0)
     return DP83822_STATUS_WRITE_ERROR;
   return DP83822_STATUS_OK;
 }
@@ -292,44 +754,2261 @@ int32_t DP83822_EnableLoopbackMode(dp83822_Object_t *pObj)
 int32_t DP83822_DisableLoopbackMode(dp83822_Object_t *pObj)
 {
   uint32_t bcr = 0;
-  if(pObj->IO.ReadReg(pObj->DevAddr, DP83822_BMCR, &bcr) < 0)
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
     return DP83822_STATUS_READ_ERROR;
   bcr &= ~DP83822_BMCR_LOOPBACK;
-  if(pObj->IO.WriteReg(pObj->DevAddr, DP83822_BMCR, bcr) < 0)
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, bcr) < 0)
     return DP83822_STATUS_WRITE_ERROR;
   return DP83822_STATUS_OK;
 }
 
-/* Interrupt and status functions would follow similar patterns */
-
 /**
-  * @brief  Read PHY register (wrap HAL)
+  * @brief  Set the abilities advertised by autonegotiation and restart it.
+  *         The advertisement is kept in the object and restored by the init
+  *         after its soft reset, before init it is only recorded.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Abilities: DP83822_ANAR_100BASE_TX_FD, DP83822_ANAR_100BASE_TX,
+  *         DP83822_ANAR_10BASE_T_FD, DP83822_ANAR_10BASE_T combination, plus
+  *         DP83822_ANAR_PO_SYMMETRIC_PAUSE and/or DP83822_ANAR_PO_ASYMMETRIC_PAUSE
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if Abilities is invalid or has no technology
   */
-static int32_t DP83822_ReadReg(uint32_t PhyAddr, uint32_t RegAddr, uint32_t *RegVal)
+int32_t DP83822_SetAdvertisement(dp83822_Object_t *pObj, uint32_t Abilities)
 {
-#ifdef USE_HAL_ETH_REGISTER_CALLBACKS
-  extern ETH_HandleTypeDef heth;
-  if(HAL_ETH_ReadPHYRegister(&heth, PhyAddr, RegAddr, RegVal) == HAL_OK)
+  uint32_t bcr = 0;
+
+  if((Abilities & ~DP83822_ANAR_ADVERTISE_MASK) || !(Abilities & DP83822_ANAR_TECHNOLOGY_MASK))
+    return DP83822_STATUS_ERROR;
+
+  pObj->Advertise = Abilities;
+
+  if(!pObj->Is_Initialized)
     return DP83822_STATUS_OK;
-  else
+
+  if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_ANAR, Abilities | DP83822_ANAR_SELECTOR_IEEE802_3) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
     return DP83822_STATUS_READ_ERROR;
-#else
-  return DP83822_STATUS_READ_ERROR;
-#endif
+
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, bcr | DP83822_BMCR_AUTONEGO_EN | DP83822_BMCR_RESTART_AUTONEGO) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  DP83822_LogEvent(pObj, DP83822_EVENT_AUTONEGO_START, 0, 0);
+  return DP83822_STATUS_OK;
 }
 
 /**
-  * @brief  Write PHY register (wrap HAL)
+  * @brief  Resolve the autonegotiation result from ANAR, ANLPAR, ANER and
+  *         PHYSTS, read in one MDIO job: the highest common technology and,
+  *         in full duplex, the flow control the MAC must apply (IEEE 802.3
+  *         Annex 28B). A partner that does not negotiate is parallel
+  *         detected, the link then runs without flow control.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pResult: pointer to hold the result
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
   */
-static int32_t DP83822_WriteReg(uint32_t PhyAddr, uint32_t RegAddr, uint32_t RegVal)
+int32_t DP83822_GetAutoNego(dp83822_Object_t *pObj, dp83822_AutoNego_t *pResult)
 {
-#ifdef USE_HAL_ETH_REGISTER_CALLBACKS
-  extern ETH_HandleTypeDef heth;
-  if(HAL_ETH_WritePHYRegister(&heth, PhyAddr, RegAddr, RegVal) == HAL_OK)
+  dp83822_RegOp_t ops[4] = { { DP83822_ANAR, 0 }, { DP83822_ANLPAR, 0 }, { DP83822_ANER, 0 }, { DP83822_PHYSTS, 0 } };
+  uint32_t local, partner, common;
+
+  if(DP83822_ReadRegs(pObj, ops, 4) < 0)
+    return DP83822_STATUS_READ_ERROR;
+  pObj->PhystsLatch |= ops[3].RegVal & DP83822_PHYSTS_LATCH_MASK;
+
+  local   = ops[0].RegVal;
+  partner = ops[1].RegVal;
+  common  = local & partner & DP83822_ANAR_TECHNOLOGY_MASK;
+
+  pResult->Advertised          = (uint16_t)local;
+  pResult->Partner             = (uint16_t)partner;
+  pResult->Expansion           = (uint16_t)ops[2].RegVal;
+  pResult->PartnerAutoNego     = (ops[2].RegVal & DP83822_ANER_LP_AUTONEG_ABLE) != 0;
+  pResult->ParallelDetectFault = (ops[2].RegVal & DP83822_ANER_PARALLEL_DETECT_FAULT) != 0;
+  pResult->Pause               = 0;
+
+  if(!(ops[3].RegVal & DP83822_PHYSTS_LINK_STATUS) || !(ops[3].RegVal & DP83822_PHYSTS_AUTONEGO_DONE))
+  {
+    pResult->LinkState = DP83822_STATUS_AUTONEGO_NOTDONE;
+    return DP83822_STATUS_OK;
+  }
+
+  if(!pResult->PartnerAutoNego)
+  {
+    pResult->LinkState = DP83822_DecodePhysts(ops[3].RegVal);
     return DP83822_STATUS_OK;
+  }
+
+  if(common & DP83822_ANAR_100BASE_TX_FD)
+    pResult->LinkState = DP83822_STATUS_100MBITS_FULLDUPLEX;
+  else if(common & DP83822_ANAR_100BASE_TX)
+    pResult->LinkState = DP83822_STATUS_100MBITS_HALFDUPLEX;
+  else if(common & DP83822_ANAR_10BASE_T_FD)
+    pResult->LinkState = DP83822_STATUS_10MBITS_FULLDUPLEX;
   else
-    return DP83822_STATUS_WRITE_ERROR;
-#else
-  return DP83822_STATUS_WRITE_ERROR;
-#endif
+    pResult->LinkState = DP83822_STATUS_10MBITS_HALFDUPLEX;
+
+  if(pResult->LinkState == DP83822_STATUS_100MBITS_FULLDUPLEX ||
+     pResult->LinkState == DP83822_STATUS_10MBITS_FULLDUPLEX)
+  {
+    if(local & partner & DP83822_ANAR_PO_SYMMETRIC_PAUSE)
+    {
+      pResult->Pause = DP83822_PAUSE_TX | DP83822_PAUSE_RX;
+    }
+    else if(local & partner & DP83822_ANAR_PO_ASYMMETRIC_PAUSE)
+    {
+      if(local & DP83822_ANAR_PO_SYMMETRIC_PAUSE)
+        pResult->Pause = DP83822_PAUSE_RX;
+      else if(partner & DP83822_ANAR_PO_SYMMETRIC_PAUSE)
+        pResult->Pause = DP83822_PAUSE_TX;
+    }
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Advertise Energy Efficient Ethernet (802.3az) at 100BASE-TX, or
+  *         stop advertising it. The advertisement is restored after every
+  *         soft reset. EEE is resolved by autonegotiation, which is
+  *         restarted when it is enabled; a forced link never enters LPI.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Mode: DP83822_EEE_ENABLED, DP83822_EEE_DISABLED, or
+  *         DP83822_EEE_DEFAULT to leave the PHY setting alone from the next init
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if Mode is invalid or the PHY is not EEE capable
+  */
+int32_t DP83822_SetEee(dp83822_Object_t *pObj, uint32_t Mode)
+{
+  uint32_t cap = 0, bcr = 0;
+  int32_t status;
+
+  if(Mode > DP83822_EEE_ENABLED)
+    return DP83822_STATUS_ERROR;
+
+  if(!pObj->Is_Initialized || Mode == DP83822_EEE_DEFAULT)
+  {
+    pObj->EeeMode = Mode;
+    return DP83822_STATUS_OK;
+  }
+
+  if((status = DP83822_ReadExtReg(pObj, DP83822_MMD_PCS, DP83822_EEE_CAPABILITY, &cap)) < 0)
+    return status;
+  if(Mode == DP83822_EEE_ENABLED && !(cap & DP83822_EEE_100BASE_TX))
+    return DP83822_STATUS_ERROR;
+
+  pObj->EeeMode = Mode;
+  if((status = DP83822_WriteEee(pObj)) < 0)
+    return status;
+
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  if(bcr & DP83822_BMCR_AUTONEGO_EN)
+  {
+    if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, bcr | DP83822_BMCR_RESTART_AUTONEGO) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+
+    DP83822_LogEvent(pObj, DP83822_EVENT_AUTONEGO_START, 0, 0);
+  }
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Get the EEE capability, both advertisements and whether the
+  *         link runs with EEE. 10 MDIO frames.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pResult: pointer to hold the EEE resolution
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_GetEee(dp83822_Object_t *pObj, dp83822_Eee_t *pResult)
+{
+  uint16_t an[2];
+  uint32_t cap = 0, physts = 0;
+  int32_t status;
+
+  if((status = DP83822_ReadExtReg(pObj, DP83822_MMD_PCS, DP83822_EEE_CAPABILITY, &cap)) < 0 ||
+     (status = DP83822_ReadExtRegs(pObj, DP83822_MMD_AUTONEGO, DP83822_EEE_ADVERTISE, an, 2)) < 0)
+    return status;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_PHYSTS, &physts) < 0)
+    return DP83822_STATUS_READ_ERROR;
+  pObj->PhystsLatch |= physts & DP83822_PHYSTS_LATCH_MASK;
+
+  pResult->Capable           = (cap & DP83822_EEE_100BASE_TX) != 0;
+  pResult->Advertised        = (an[0] & DP83822_EEE_100BASE_TX) != 0;
+  pResult->PartnerAdvertised = (an[1] & DP83822_EEE_100BASE_TX) != 0;
+  pResult->Active            = pResult->Advertised && pResult->PartnerAdvertised &&
+                               (physts & DP83822_PHYSTS_LINK_STATUS) && (physts & DP83822_PHYSTS_AUTONEGO_DONE) &&
+                               (physts & DP83822_PHYSTS_DUPLEX_MASK) && !(physts & DP83822_PHYSTS_SPEED_MASK);
+  pResult->WakeUs            = pResult->Active ? DP83822_EEE_TW_SYS_TX_US : 0U;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Sample the LPI state of both paths and add it to pObj->Lpi.
+  *         The PCS only shows the current LPI state and a latched "LPI seen"
+  *         bit, so one sample finds at most one entry and one exit per path
+  *         and LPI time is interpolated between samples: sample faster than
+  *         the idle pattern of the traffic for exact counts. Entries and
+  *         exits are lower bounds, WakeStallUs is the worst case delay the
+  *         exits added to frames waiting to be sent. 8 MDIO frames.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pDelta: pointer to hold the counts of this sample, may be NULL
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_GetLpiStats(dp83822_Object_t *pObj, dp83822_LpiStats_t *pDelta)
+{
+  static const dp83822_LpiStats_t cleared = { 0 };
+  dp83822_LpiStats_t *total = &pObj->Lpi;
+  dp83822_LpiStats_t delta = cleared;
+  uint32_t pcs = 0, errors = 0, now, prev = 0;
+  int32_t status;
+
+  if((status = DP83822_ReadExtReg(pObj, DP83822_MMD_PCS, DP83822_PCS_STATUS1, &pcs)) < 0 ||
+     (status = DP83822_ReadExtReg(pObj, DP83822_MMD_PCS, DP83822_EEE_WAKE_ERRORS, &errors)) < 0)
+    return status;
+
+  now = (uint32_t)pObj->IO.GetTick();
+
+  /* The first sample only sets the starting point */
+  if(total->Samples != 0)
+  {
+    delta.ElapsedMs = now - pObj->LpiTick;
+    prev = pObj->LpiStatus;
+  }
+
+  DP83822_CountLpi(prev, pcs, DP83822_PCS_STATUS1_TX_LPI_IND, DP83822_PCS_STATUS1_TX_LPI_RCVD, delta.ElapsedMs,
+                   &delta.TxEntries, &delta.TxExits, &delta.TxLpiMs);
+  DP83822_CountLpi(prev, pcs, DP83822_PCS_STATUS1_RX_LPI_IND, DP83822_PCS_STATUS1_RX_LPI_RCVD, delta.ElapsedMs,
+                   &delta.RxEntries, &delta.RxExits, &delta.RxLpiMs);
+  delta.WakeErrors  = errors & 0xFFFFU;
+  delta.WakeStallUs = delta.TxExits * DP83822_EEE_TW_SYS_TX_US;
+  delta.Samples     = 1;
+
+  pObj->LpiStatus = pcs;
+  pObj->LpiTick   = now;
+
+  total->TxEntries   += delta.TxEntries;
+  total->TxExits     += delta.TxExits;
+  total->RxEntries   += delta.RxEntries;
+  total->RxExits     += delta.RxExits;
+  total->TxLpiMs     += delta.TxLpiMs;
+  total->RxLpiMs     += delta.RxLpiMs;
+  total->WakeErrors  += delta.WakeErrors;
+  total->WakeStallUs += delta.WakeStallUs;
+  total->ElapsedMs   += delta.ElapsedMs;
+  total->Samples     += delta.Samples;
+
+  if(pDelta)
+  {
+    *pDelta = delta;
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Bring the link up at a known speed/duplex on the next init
+  *         instead of a full autonegotiation cycle, for fixed topologies
+  *         (backplanes, known switch ports). Autonegotiation is started if no
+  *         link appears within the deadline. Pass the link state retained
+  *         from a previous boot, e.g. the DP83822_GetLinkState() result. A
+  *         partner that still autonegotiates detects the speed in parallel
+  *         but assumes half duplex, use it against forced partners only.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  LinkState: DP83822_STATUS_100MBITS_FULLDUPLEX,
+  *         DP83822_STATUS_100MBITS_HALFDUPLEX or DP83822_STATUS_10MBITS_FULLDUPLEX,
+  *         0 to always autonegotiate
+  * @param  TimeoutMs: forced mode deadline, 0 for DP83822_FAST_START_TIMEOUT_VALUE
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if LinkState is invalid
+  */
+int32_t DP83822_SetFastStart(dp83822_Object_t *pObj, uint32_t LinkState, uint32_t TimeoutMs)
+{
+  uint32_t bcr = 0;
+
+  if(LinkState && DP83822_ForcedCtrl(LinkState, &bcr) < 0)
+    return DP83822_STATUS_ERROR;
+
+  pObj->FastStartState   = LinkState;
+  pObj->FastStartTimeout = TimeoutMs;
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Select the fast auto-MDIX and fast autonegotiation timer options.
+  *         They are kept in the object and restored after every soft reset
+  *         by the init, before the link is brought up.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Options: DP83822_FAST_xxx combination, 0 for standard timers
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if Options is invalid
+  */
+int32_t DP83822_SetFastTimers(dp83822_Object_t *pObj, uint32_t Options)
+{
+  if(Options & ~DP83822_FAST_ALL)
+    return DP83822_STATUS_ERROR;
+
+  pObj->FastTimers = Options;
+
+  if(pObj->Is_Initialized)
+  {
+    return DP83822_WriteFastTimers(pObj);
+  }
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Select the fast link down criteria. With none selected the link
+  *         drops after the standard 802.3 link fail timers, which can take
+  *         hundreds of milliseconds; any selected criterion drops it as soon
+  *         as the condition is seen. The criteria are restored after every
+  *         soft reset; before DP83822_Init() they are only recorded.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Criteria: DP83822_FLD_xxx combination, 0 for standard timing
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if Criteria is invalid
+  */
+int32_t DP83822_SetFastLinkDown(dp83822_Object_t *pObj, uint32_t Criteria)
+{
+  if(Criteria & ~DP83822_FLD_ALL)
+    return DP83822_STATUS_ERROR;
+
+  pObj->FastLinkDown = Criteria;
+
+  if(pObj->Is_Initialized)
+  {
+    return DP83822_WriteFastLinkDown(pObj);
+  }
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Register a board register profile, a constant table applied by
+  *         every init right after the soft reset, after the fast timers and
+  *         advertisement so its settings win. Applied at once if the PHY is
+  *         already initialized. BMCR and PHYSCR belong to the link and
+  *         interrupt API, CR1 and CR3 to DP83822_SetFastTimers() and
+  *         DP83822_SetFastLinkDown(), MMDACR/MMDAADR to the extended register
+  *         access, MMD 7.60 to DP83822_SetEee() and the receive filter
+  *         block RXFCFG..RXFPATC to DP83822_SetWol(). Reading BMSR, PHYSTS,
+  *         MISR1/2, FCSCR, RECR, BICSR1, PCS status 1 or the EEE wake error
+  *         counter would clear state the driver accumulates. Entries for
+  *         any of them are rejected.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pEntries: profile table, must stay valid, NULL to remove the profile
+  * @param  Count: entries in pEntries
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if an entry is invalid or did not verify
+  */
+int32_t DP83822_SetProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count)
+{
+  if(pEntries == 0)
+    Count = 0;
+  if(!DP83822_ProfileValid(pEntries, Count))
+    return DP83822_STATUS_ERROR;
+
+  pObj->pProfile     = (Count != 0) ? pEntries : 0;
+  pObj->ProfileCount = Count;
+
+  if(pObj->Is_Initialized && Count != 0)
+  {
+    return DP83822_ApplyProfile(pObj, pEntries, Count, 0);
+  }
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Apply a register profile, writing only the registers whose
+  *         masked bits differ and reading back only those. Runs of basic
+  *         registers cost one batched read, one batched write of the
+  *         differences and one batched read-back. An extended register costs
+  *         4 frames when it already holds its value and 6 when written, the
+  *         write and read-back reuse the address set up for the read.
+  *         Entries are applied in table order, entries for the same basic
+  *         register in a run are merged into one write.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pEntries: profile table
+  * @param  Count: entries in pEntries
+  * @param  pResult: pointer to hold the write and verify counts, may be NULL
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if an entry is invalid or did not verify
+  */
+int32_t DP83822_ApplyProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count,
+                             dp83822_ProfileResult_t *pResult)
+{
+  return DP83822_RunProfile(pObj, pEntries, Count, 1, pResult);
+}
+
+/**
+  * @brief  Check that the PHY still holds a register profile without
+  *         writing anything, one read per register.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pEntries: profile table
+  * @param  Count: entries in pEntries
+  * @param  pResult: pointer to hold the mismatch count, may be NULL
+  * @retval DP83822_STATUS_OK if every entry matches
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if an entry is invalid or does not match
+  */
+int32_t DP83822_VerifyProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count,
+                              dp83822_ProfileResult_t *pResult)
+{
+  return DP83822_RunProfile(pObj, pEntries, Count, 0, pResult);
+}
+
+/**
+  * @brief  Attribute a link loss to the enabled fast link down criterion
+  *         that fired, from a single PHYSTS read. The DP83822 does not latch
+  *         the criterion, so it is inferred: no signal detect is energy loss,
+  *         signal without descrambler lock is sync loss, and a latched
+  *         receive error is RX errors, or MLT3 errors when only those are
+  *         enabled since MLT3 code violations are flagged as receive errors.
+  *         Without such an indication the cause is left unknown. Call it
+  *         once the link is reported down.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pCause: pointer to hold the DP83822_FLD_xxx criterion, 0 if the
+  *         link is up or no enabled criterion explains the drop
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_GetLinkDownCause(dp83822_Object_t *pObj, uint32_t *pCause)
+{
+  uint32_t physts = 0, cause = 0;
+
+  *pCause = 0;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_PHYSTS, &physts) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  physts |= pObj->PhystsLatch;
+  pObj->PhystsLatch = 0;
+
+  if(physts & DP83822_PHYSTS_LINK_STATUS)
+    return DP83822_STATUS_OK;
+
+  /* Conditions present, energy loss also loses descrambler sync */
+  if(!(physts & DP83822_PHYSTS_SIGNAL_DETECT))
+    cause |= DP83822_FLD_ENERGY_LOST | DP83822_FLD_DESCRAMBLER_LOSS;
+  if(!(physts & DP83822_PHYSTS_DESCRAMBLER_LOCK))
+    cause |= DP83822_FLD_DESCRAMBLER_LOSS;
+  if(physts & DP83822_PHYSTS_RX_ERROR_LATCH)
+    cause |= DP83822_FLD_RX_ERRORS | DP83822_FLD_MLT3_ERRORS;
+
+  /* Report the most fundamental enabled one */
+  cause &= pObj->FastLinkDown;
+  if(cause & DP83822_FLD_ENERGY_LOST)
+    cause = DP83822_FLD_ENERGY_LOST;
+  else if(cause & DP83822_FLD_DESCRAMBLER_LOSS)
+    cause = DP83822_FLD_DESCRAMBLER_LOSS;
+  else if(cause & DP83822_FLD_RX_ERRORS)
+    cause = DP83822_FLD_RX_ERRORS;
+
+  *pCause = cause;
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Sample the hardware error counters. RECR and FCSCR are read in
+  *         one MDIO job (DP83822_COUNTER_NB frames), their clear-on-read
+  *         values are added to the 64-bit totals in pObj->Counters. A counter
+  *         read at its saturation value may have missed events, sample more
+  *         often if Saturated is reported.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pDelta: pointer to hold the counts of this sample, may be NULL
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_GetCounters(dp83822_Object_t *pObj, dp83822_Counters_t *pDelta)
+{
+  dp83822_RegOp_t ops[DP83822_COUNTER_NB] = { { DP83822_RECR, 0 }, { DP83822_FCSCR, 0 } };
+  dp83822_Counters_t *total = &pObj->Counters;
+  dp83822_Counters_t delta;
+
+  if(DP83822_ReadRegs(pObj, ops, DP83822_COUNTER_NB) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  delta.RxErrors     = ops[0].RegVal & DP83822_RECR_RXERCNT;
+  delta.FalseCarrier = ops[1].RegVal & DP83822_FCSCR_FCSCNT;
+  delta.Saturated    = 0;
+  delta.Samples      = 1;
+  delta.Frames       = DP83822_COUNTER_NB;
+
+  if(delta.RxErrors == DP83822_RECR_RXERCNT)
+    delta.Saturated |= DP83822_COUNTER_RX_ERROR;
+  if(delta.FalseCarrier == DP83822_FCSCR_FCSCNT)
+    delta.Saturated |= DP83822_COUNTER_FALSE_CARRIER;
+
+  total->RxErrors     += delta.RxErrors;
+  total->FalseCarrier += delta.FalseCarrier;
+  total->Saturated    |= delta.Saturated;
+  total->Samples      += delta.Samples;
+  total->Frames       += delta.Frames;
+
+  if(pDelta)
+  {
+    *pDelta = delta;
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Start a BIST run: the PRBS packet generator sends into the chosen
+  *         loopback point and the PRBS checker counts the errored bytes that
+  *         come back. Near end loopbacks force 100 Mbit/s full duplex, the
+  *         reverse loopback keeps the current link and needs a partner that
+  *         loops the stream back. BMCR is restored when the run ends.
+  *         Does not block, advance it with DP83822_PollSelfTest().
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pCfg: loopback point, packet format and run length
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if a run is in progress or pCfg is invalid
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_StartSelfTest(dp83822_Object_t *pObj, const dp83822_SelfTestCfg_t *pCfg)
+{
+  static const dp83822_SelfTestResult_t cleared = { 0 };
+  dp83822_SelfTest_t *test = &pObj->SelfTest;
+  dp83822_RegOp_t ops[3];
+  uint32_t length = (pCfg->PacketLength != 0) ? pCfg->PacketLength : DP83822_BIST_PACKET_LENGTH;
+  uint32_t ipg = (pCfg->IpgLength != 0) ? pCfg->IpgLength : DP83822_BIST_IPG_LENGTH;
+  uint32_t bcr = 0, count = 0;
+  uint64_t duration;
+
+  /* Exactly one loopback point */
+  if(test->State != DP83822_BIST_STATE_IDLE || !pObj->Is_Initialized ||
+     (pCfg->Loopback & ~DP83822_BISCR_LOOPBACK_MASK) != 0 ||
+     pCfg->Loopback == 0 || (pCfg->Loopback & (pCfg->Loopback - 1U)) != 0 ||
+     length > DP83822_BICSR2_PACKET_LENGTH || ipg > DP83822_BICSR1_IPG_LENGTH)
+    return DP83822_STATUS_ERROR;
+
+  /* Packet, gap and 8 bytes of preamble/SFD on the wire */
+  test->PacketLength = length;
+  test->FrameBits    = (length + ipg + 8U) * 8U;
+
+  duration = pCfg->DurationMs;
+  if(duration == 0)
+  {
+    duration = ((uint64_t)pCfg->PacketCount * test->FrameBits + DP83822_BIST_LINE_RATE_KBPS - 1U) /
+               DP83822_BIST_LINE_RATE_KBPS;
+    if(duration == 0)
+      return DP83822_STATUS_ERROR;
+  }
+  test->DurationMs = (duration > DP83822_BIST_MAX_DURATION) ? DP83822_BIST_MAX_DURATION : (uint32_t)duration;
+
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
+    return DP83822_STATUS_READ_ERROR;
+  test->SavedBcr = bcr;
+
+  if(pCfg->Loopback != DP83822_BIST_LOOPBACK_REVERSE)
+  {
+    if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, DP83822_BMCR_SPEED_SELECT | DP83822_BMCR_DUPLEX_MODE) < 0)
+    {
+      DP83822_StopSelfTest(pObj);
+      return DP83822_STATUS_WRITE_ERROR;
+    }
+  }
+
+  /* Drop the clear-on-read error count left by a previous run */
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_BICSR1, &count) < 0)
+  {
+    /* Do not leave the link forced for a test that never started */
+    DP83822_StopSelfTest(pObj);
+    return DP83822_STATUS_READ_ERROR;
+  }
+
+  ops[0].RegAddr = DP83822_BICSR1;
+  ops[0].RegVal  = ipg;
+  ops[1].RegAddr = DP83822_BICSR2;
+  ops[1].RegVal  = length;
+  ops[2].RegAddr = DP83822_BISCR;
+  ops[2].RegVal  = pCfg->Loopback | DP83822_BISCR_PACKET_GEN_EN;
+  if(DP83822_WriteRegs(pObj, ops, 3) < 0)
+  {
+    DP83822_StopSelfTest(pObj);
+    return DP83822_STATUS_WRITE_ERROR;
+  }
+
+  test->Result    = cleared;
+  test->StartTick = (uint32_t)pObj->IO.GetTick();
+  test->State     = DP83822_BIST_STATE_RUNNING;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Advance the run started by DP83822_StartSelfTest(). Each call
+  *         reads BICSR1 and BISCR in one MDIO job and adds the error count
+  *         to the result. The 8-bit hardware counter saturates at 255, poll
+  *         often enough on a noisy path or Saturated is reported. Once the
+  *         run time has elapsed the generator is stopped and BMCR restored.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pResult: pointer to hold the result so far, may be NULL
+  * @retval DP83822_STATUS_BUSY if the run is in progress
+  *         DP83822_STATUS_OK if the run is complete
+  *         DP83822_STATUS_ERROR if no run was started, or the PRBS checker
+  *         never locked (the loopback path is broken, see pResult->Locked)
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_PollSelfTest(dp83822_Object_t *pObj, dp83822_SelfTestResult_t *pResult)
+{
+  dp83822_SelfTest_t *test = &pObj->SelfTest;
+  dp83822_SelfTestResult_t *result = &test->Result;
+  dp83822_RegOp_t ops[2] = { { DP83822_BICSR1, 0 }, { DP83822_BISCR, 0 } };
+  uint32_t elapsed, errors;
+  int32_t status = DP83822_STATUS_BUSY;
+
+  if(test->State != DP83822_BIST_STATE_RUNNING)
+    return DP83822_STATUS_ERROR;
+
+  elapsed = (uint32_t)pObj->IO.GetTick() - test->StartTick;
+
+  if(DP83822_ReadRegs(pObj, ops, 2) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  errors = (ops[0].RegVal & DP83822_BICSR1_ERR_COUNT) >> 8;
+  result->ErrorBytes += errors;
+  if(errors == (DP83822_BICSR1_ERR_COUNT >> 8))
+    result->Saturated = 1;
+  if(ops[1].RegVal & DP83822_BISCR_PRBS_LOCK)
+    result->Locked = 1;
+  if(ops[1].RegVal & DP83822_BISCR_PRBS_SYNC_LOSS)
+    result->SyncLoss = 1;
+
+  if(elapsed >= test->DurationMs)
+  {
+    elapsed = test->DurationMs;
+    if(DP83822_StopSelfTest(pObj) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+    status = result->Locked ? DP83822_STATUS_OK : DP83822_STATUS_ERROR;
+  }
+
+  DP83822_SelfTestRate(pObj, elapsed);
+
+  if(pResult)
+  {
+    *pResult = *result;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Stop a run started by DP83822_StartSelfTest() early and restore
+  *         BMCR. The partial result stays in pObj->SelfTest.Result.
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_AbortSelfTest(dp83822_Object_t *pObj)
+{
+  if(pObj->SelfTest.State != DP83822_BIST_STATE_RUNNING)
+    return DP83822_STATUS_OK;
+
+  if(DP83822_StopSelfTest(pObj) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Start a TDR cable measurement on the TX and RX pairs. The link
+  *         drops while the pulses are sent and comes back by itself.
+  *         Does not block, advance it with DP83822_PollCableDiag().
+  * @param  pObj: device object dp83822_Object_t.
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if a measurement is in progress or the
+  *         device is not initialized
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_StartCableDiag(dp83822_Object_t *pObj)
+{
+  if(pObj->CableDiagRunning || !pObj->Is_Initialized)
+    return DP83822_STATUS_ERROR;
+
+  if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_CDCR, DP83822_CDCR_DIAG_START) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  pObj->CableDiagTick    = (uint32_t)pObj->IO.GetTick();
+  pObj->CableDiagRunning = 1;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Advance the measurement started by DP83822_StartCableDiag().
+  *         Costs one CDCR read while busy, then one burst of the result
+  *         registers (DP83822_CABLE_DIAG_REG_NB + 3 frames). The first
+  *         reflection above DP83822_TDR_PEAK_THRESHOLD decides the fault of
+  *         each pair, an unplugged cable reads as open at its far end.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pResult: pointer to hold the fault and distance of each pair
+  * @retval DP83822_STATUS_BUSY if the measurement is in progress
+  *         DP83822_STATUS_OK if pResult holds the result
+  *         DP83822_STATUS_ERROR if no measurement was started, the PHY
+  *         reported a failure or DP83822_TDR_TIMEOUT_VALUE elapsed
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_PollCableDiag(dp83822_Object_t *pObj, dp83822_CableDiag_t *pResult)
+{
+  uint16_t regs[DP83822_CABLE_DIAG_REG_NB];
+  uint32_t cdcr = 0, pair;
+  int32_t status;
+
+  if(!pObj->CableDiagRunning)
+    return DP83822_STATUS_ERROR;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_CDCR, &cdcr) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  if(!(cdcr & (DP83822_CDCR_DIAG_DONE | DP83822_CDCR_DIAG_FAIL)))
+  {
+    if(((uint32_t)pObj->IO.GetTick() - pObj->CableDiagTick) < DP83822_TDR_TIMEOUT_VALUE)
+      return DP83822_STATUS_BUSY;
+
+    pObj->CableDiagRunning = 0;
+    return DP83822_STATUS_ERROR;
+  }
+
+  pObj->CableDiagRunning = 0;
+
+  if(cdcr & DP83822_CDCR_DIAG_FAIL)
+    return DP83822_STATUS_ERROR;
+
+  status = DP83822_ReadExtRegs(pObj, DP83822_MMD_VENDOR, DP83822_CDLRR1, regs, DP83822_CABLE_DIAG_REG_NB);
+  if(status < 0)
+    return status;
+
+  for(pair = 0; pair < DP83822_CABLE_PAIR_NB; pair++)
+  {
+    DP83822_DecodeCablePair(regs, pair, &pResult->Pair[pair]);
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Estimate the cable length from the adaptive equalizer setting,
+  *         without disturbing the link. Coarse, DP83822_CABLE_CM_PER_EQ_STEP
+  *         should be calibrated against the cable type in use.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pLengthCm: pointer to hold the estimated length
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_LINK_DOWN if there is no 100BASE-TX link to measure
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_GetCableLength(dp83822_Object_t *pObj, uint32_t *pLengthCm)
+{
+  uint32_t physts = 0, eq = 0;
+  int32_t status;
+
+  *pLengthCm = 0;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_PHYSTS, &physts) < 0)
+    return DP83822_STATUS_READ_ERROR;
+  pObj->PhystsLatch |= physts & DP83822_PHYSTS_LATCH_MASK;
+
+  /* The equalizer only adapts on a 100 Mbit/s link */
+  if(!(physts & DP83822_PHYSTS_LINK_STATUS) || (physts & DP83822_PHYSTS_SPEED_MASK))
+    return DP83822_STATUS_LINK_DOWN;
+
+  status = DP83822_ReadExtReg(pObj, DP83822_MMD_VENDOR, DP83822_DSP_EQ_STATUS, &eq);
+  if(status < 0)
+    return status;
+
+  *pLengthCm = (eq & DP83822_DSP_EQ_SETTING) * DP83822_CABLE_CM_PER_EQ_STEP;
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Set up a poll scheduler for the PHYs sharing one MDIO bus.
+  *         Each port is polled every MinInterval after a link change or
+  *         while autonegotiation runs, the period doubles on every stable
+  *         poll up to MaxInterval.
+  * @param  pSched: scheduler to set up
+  * @param  MinInterval: fast poll period in ms, 0 for DP83822_SCHED_MIN_INTERVAL
+  * @param  MaxInterval: stable poll period in ms, 0 for DP83822_SCHED_MAX_INTERVAL
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if MaxInterval is below MinInterval
+  */
+int32_t DP83822_SchedInit(dp83822_Sched_t *pSched, uint32_t MinInterval, uint32_t MaxInterval)
+{
+  if(MinInterval == 0)
+    MinInterval = DP83822_SCHED_MIN_INTERVAL;
+  if(MaxInterval == 0)
+    MaxInterval = DP83822_SCHED_MAX_INTERVAL;
+  if(MaxInterval < MinInterval)
+    return DP83822_STATUS_ERROR;
+
+  pSched->PortCount   = 0;
+  pSched->StartTick   = 0;
+  pSched->MinInterval = MinInterval;
+  pSched->MaxInterval = MaxInterval;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Hand a PHY object to the scheduler. Its first poll is due one
+  *         slot (1 ms) after the previous port's so polls never line up.
+  * @param  pSched: scheduler set up by DP83822_SchedInit()
+  * @param  pObj: device object dp83822_Object_t, with its IO registered
+  * @retval Port index if OK
+  *         DP83822_STATUS_ERROR if the scheduler is full
+  */
+int32_t DP83822_SchedAddPort(dp83822_Sched_t *pSched, dp83822_Object_t *pObj)
+{
+  static const dp83822_SchedPort_t cleared = { 0 };
+  dp83822_SchedPort_t *port;
+  uint32_t now;
+
+  if(pSched->PortCount >= DP83822_SCHED_MAX_PORTS || !pObj->IO.GetTick)
+    return DP83822_STATUS_ERROR;
+
+  now = (uint32_t)pObj->IO.GetTick();
+  if(pSched->PortCount == 0)
+    pSched->StartTick = now;
+
+  port = &pSched->Port[pSched->PortCount];
+  *port = cleared;
+  port->pObj     = pObj;
+  port->Interval = pSched->MinInterval;
+  port->NextTick = now + pSched->PortCount;
+  port->LastTick = now;
+
+  return (int32_t)pSched->PortCount++;
+}
+
+/**
+  * @brief  Poll the most overdue initialized port, at most one per call.
+  *         Call it every millisecond: the bus then carries at most one link
+  *         poll per slot however many ports fall due together, and load
+  *         stays flat. The poll goes through DP83822_GetLinkState(), so link
+  *         events are logged as usual.
+  * @param  pSched: scheduler set up by DP83822_SchedInit()
+  * @param  pChanged: pointer to hold a bit per port whose link state changed, may be NULL
+  * @retval DP83822_STATUS_OK if OK or no port was due
+  *         DP83822_STATUS_READ_ERROR if the polled port could not be read
+  */
+int32_t DP83822_SchedRun(dp83822_Sched_t *pSched, uint32_t *pChanged)
+{
+  dp83822_SchedPort_t *port;
+  uint32_t now, late, worst = 0, frames, gap, due, i;
+  int32_t state;
+
+  if(pChanged)
+    *pChanged = 0;
+
+  if(pSched->PortCount == 0)
+    return DP83822_STATUS_OK;
+
+  now = (uint32_t)pSched->Port[0].pObj->IO.GetTick();
+
+  due = pSched->PortCount;
+  for(i = 0; i < pSched->PortCount; i++)
+  {
+    late = now - pSched->Port[i].NextTick;
+    if(pSched->Port[i].pObj->Is_Initialized && (int32_t)late >= 0 && (due == pSched->PortCount || late > worst))
+    {
+      due   = i;
+      worst = late;
+    }
+  }
+
+  if(due == pSched->PortCount)
+    return DP83822_STATUS_OK;
+
+  port = &pSched->Port[due];
+
+  frames = port->pObj->FrameCount;
+  state  = DP83822_GetLinkState(port->pObj);
+  frames = port->pObj->FrameCount - frames;
+
+  port->Frames += frames;
+  port->BusNs  += (uint64_t)frames * (port->pObj->PreambleSuppressed ? DP83822_MDIO_FRAME_NS / 2U : DP83822_MDIO_FRAME_NS);
+  port->Polls++;
+
+  /* A change right after the previous poll is seen this late */
+  gap = now - port->LastTick;
+  if(port->Polls > 1 && gap > port->MaxGap)
+    port->MaxGap = gap;
+  port->LastTick = now;
+
+  if(state < 0)
+  {
+    port->Interval = pSched->MinInterval;
+    port->NextTick = now + port->Interval;
+    return state;
+  }
+
+  if(state != port->LinkState || state == DP83822_STATUS_AUTONEGO_NOTDONE || port->pObj->Debounce.Pending)
+  {
+    if(port->LinkState != 0 && state != port->LinkState)
+    {
+      port->Changes++;
+      if(pChanged)
+        *pChanged |= 1UL << due;
+    }
+    port->Interval = pSched->MinInterval;
+  }
+  else
+  {
+    port->Interval = (port->Interval >= pSched->MaxInterval / 2U) ? pSched->MaxInterval : port->Interval * 2U;
+  }
+
+  port->LinkState = state;
+  port->NextTick  = now + port->Interval;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Get the poll statistics of one port or of the whole bus. The
+  *         bus share assumes DP83822_MDIO_FRAME_NS per frame.
+  * @param  pSched: scheduler set up by DP83822_SchedInit()
+  * @param  Port: port index, or DP83822_SCHED_ALL_PORTS for the totals
+  * @param  pStats: pointer to hold the statistics
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if Port is not a port of the scheduler
+  */
+int32_t DP83822_SchedGetStats(dp83822_Sched_t *pSched, uint32_t Port, dp83822_SchedStats_t *pStats)
+{
+  dp83822_SchedPort_t *port;
+  uint32_t first = Port, last = Port, elapsed, i;
+  uint64_t busns = 0;
+
+  if(Port == DP83822_SCHED_ALL_PORTS)
+  {
+    first = 0;
+    last  = pSched->PortCount - 1U;
+  }
+  if(pSched->PortCount == 0 || last >= pSched->PortCount)
+    return DP83822_STATUS_ERROR;
+
+  pStats->LinkState  = (Port == DP83822_SCHED_ALL_PORTS) ? 0 : pSched->Port[Port].LinkState;
+  pStats->Interval   = pSched->MaxInterval;
+  pStats->Polls      = 0;
+  pStats->Changes    = 0;
+  pStats->MaxLatency = 0;
+  pStats->Frames     = 0;
+
+  for(i = first; i <= last; i++)
+  {
+    port = &pSched->Port[i];
+    if(port->Interval < pStats->Interval)
+      pStats->Interval = port->Interval;
+    if(port->MaxGap > pStats->MaxLatency)
+      pStats->MaxLatency = port->MaxGap;
+    pStats->Polls   += port->Polls;
+    pStats->Changes += port->Changes;
+    pStats->Frames  += port->Frames;
+    busns += port->BusNs;
+  }
+
+  /* ns of bus time per ms of run time is ppm */
+  elapsed = (uint32_t)pSched->Port[0].pObj->IO.GetTick() - pSched->StartTick;
+  pStats->BusPpm = (elapsed != 0) ? (uint32_t)(busns / elapsed) : 0;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Copy the logged link events out, oldest first, and remove them
+  *         from the log. Costs no MDIO traffic. Call it from the context
+  *         that polls the link or drains the interrupts.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pEvents: array to hold the events
+  * @param  MaxCount: size of pEvents
+  * @param  pCount: pointer to hold the number of events copied
+  * @param  pLost: pointer to hold the number of events overwritten since
+  *         the last call, may be NULL
+  * @retval DP83822_STATUS_OK
+  */
+int32_t DP83822_ReadEvents(dp83822_Object_t *pObj, dp83822_Event_t *pEvents, uint32_t MaxCount, uint32_t *pCount,
+                           uint32_t *pLost)
+{
+  dp83822_EventLog_t *log = &pObj->Events;
+  uint32_t tail = log->Head - log->Count;
+  uint32_t count = 0;
+
+  while(count < MaxCount && count < log->Count)
+  {
+    pEvents[count] = log->Event[(tail + count) & (DP83822_EVENT_LOG_SIZE - 1U)];
+    count++;
+  }
+
+  log->Count -= count;
+  if(pLost)
+    *pLost = log->Lost;
+  log->Lost = 0;
+  *pCount = count;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Read an extended (MMD) register through MMDACR/MMDAADR.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  DevAd: MMD device address, DP83822_MMD_xxx
+  * @param  RegAddr: register address within the MMD
+  * @param  pRegVal: pointer to hold the register value
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_ReadExtReg(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint32_t *pRegVal)
+{
+  uint16_t val = 0;
+  int32_t status = DP83822_ReadExtRegs(pObj, DevAd, RegAddr, &val, 1);
+
+  *pRegVal = val;
+  return status;
+}
+
+/**
+  * @brief  Write an extended (MMD) register through MMDACR/MMDAADR.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  DevAd: MMD device address, DP83822_MMD_xxx
+  * @param  RegAddr: register address within the MMD
+  * @param  RegVal: value to write
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_WriteExtReg(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint32_t RegVal)
+{
+  uint16_t val = (uint16_t)RegVal;
+
+  return DP83822_WriteExtRegs(pObj, DevAd, RegAddr, &val, 1);
+}
+
+/**
+  * @brief  Read a block of consecutive extended registers. The address is
+  *         set up once and MMDAADR is read with the "data, post increment"
+  *         function, so N registers cost N+3 transactions instead of 4N.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  DevAd: MMD device address, DP83822_MMD_xxx
+  * @param  RegAddr: first register address within the MMD
+  * @param  pBuf: array to hold Count register values
+  * @param  Count: number of registers to read
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_ReadExtRegs(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint16_t *pBuf, uint32_t Count)
+{
+  dp83822_RegOp_t ops[DP83822_EXT_BURST_CHUNK];
+  uint32_t chunk, i;
+
+  if(DP83822_SetupExt(pObj, DevAd, RegAddr, (Count > 1U) ? DP83822_MMDACR_MMD_FUNCTION_DATA_PI
+                                                         : DP83822_MMDACR_MMD_FUNCTION_DATA) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  while(Count)
+  {
+    chunk = (Count > DP83822_EXT_BURST_CHUNK) ? DP83822_EXT_BURST_CHUNK : Count;
+
+    for(i = 0; i < chunk; i++)
+    {
+      ops[i].RegAddr = DP83822_MMDAADR;
+      ops[i].RegVal  = 0;
+    }
+
+    if(DP83822_ReadRegs(pObj, ops, chunk) < 0)
+      return DP83822_STATUS_READ_ERROR;
+
+    for(i = 0; i < chunk; i++)
+    {
+      *pBuf++ = (uint16_t)ops[i].RegVal;
+    }
+    Count -= chunk;
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Write a block of consecutive extended registers using the
+  *         "data, post increment on write" function, N+3 transactions.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  DevAd: MMD device address, DP83822_MMD_xxx
+  * @param  RegAddr: first register address within the MMD
+  * @param  pBuf: Count register values to write
+  * @param  Count: number of registers to write
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_WriteExtRegs(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, const uint16_t *pBuf, uint32_t Count)
+{
+  dp83822_RegOp_t ops[DP83822_EXT_BURST_CHUNK];
+  uint32_t chunk, i;
+
+  if(DP83822_SetupExt(pObj, DevAd, RegAddr, (Count > 1U) ? DP83822_MMDACR_MMD_FUNCTION_DATA_PIW
+                                                         : DP83822_MMDACR_MMD_FUNCTION_DATA) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  while(Count)
+  {
+    chunk = (Count > DP83822_EXT_BURST_CHUNK) ? DP83822_EXT_BURST_CHUNK : Count;
+
+    for(i = 0; i < chunk; i++)
+    {
+      ops[i].RegAddr = DP83822_MMDAADR;
+      ops[i].RegVal  = *pBuf++;
+    }
+
+    if(DP83822_WriteRegs(pObj, ops, chunk) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+
+    Count -= chunk;
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Enable interrupt sources and route them to the INTR/PWRDN pin.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Interrupt: combination of DP83822_xxx_IT flags
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_EnableIT(dp83822_Object_t *pObj, uint32_t Interrupt)
+{
+  return DP83822_WriteITMask(pObj, pObj->ITEnabled | (Interrupt & DP83822_ALL_IT), Interrupt);
+}
+
+/**
+  * @brief  Disable interrupt sources, the interrupt output is released once
+  *         no source is left enabled.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Interrupt: combination of DP83822_xxx_IT flags
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_DisableIT(dp83822_Object_t *pObj, uint32_t Interrupt)
+{
+  return DP83822_WriteITMask(pObj, pObj->ITEnabled & ~Interrupt, Interrupt);
+}
+
+/**
+  * @brief  Clear interrupt flags. Reading MISR1/MISR2 clears every latched
+  *         cause of that register, causes not requested here stay pending
+  *         for DP83822_GetITStatus() / DP83822_GetPendingIT().
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Interrupt: combination of DP83822_xxx_IT flags
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_ClearIT(dp83822_Object_t *pObj, uint32_t Interrupt)
+{
+  int32_t status = DP83822_LatchIT(pObj, Interrupt);
+
+  pObj->ITPending &= ~Interrupt;
+
+  return status;
+}
+
+/**
+  * @brief  Get interrupt flag status. A latched cause is returned without
+  *         any MDIO access, otherwise only the MISR register holding the
+  *         requested flags is read.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  Interrupt: combination of DP83822_xxx_IT flags
+  * @retval 1 if all requested flags are set, 0 otherwise
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_GetITStatus(dp83822_Object_t *pObj, uint32_t Interrupt)
+{
+  if((pObj->ITPending & Interrupt) != Interrupt)
+  {
+    if(DP83822_LatchIT(pObj, Interrupt & ~pObj->ITPending) < 0)
+      return DP83822_STATUS_READ_ERROR;
+  }
+
+  return ((pObj->ITPending & Interrupt) == Interrupt);
+}
+
+/**
+  * @brief  Drain all pending interrupt causes in one pass, intended for the
+  *         thread the INTn pin ISR defers to. Each MISR register holding an
+  *         enabled source is read exactly once, the returned causes are
+  *         consumed.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pInterrupts: pointer to hold the pending DP83822_xxx_IT flags
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  */
+int32_t DP83822_GetPendingIT(dp83822_Object_t *pObj, uint32_t *pInterrupts)
+{
+  int32_t status = DP83822_LatchIT(pObj, pObj->ITEnabled);
+
+  *pInterrupts = pObj->ITPending;
+  pObj->ITPending = 0;
+
+  return status;
+}
+
+/**
+  * @brief  Configure the Wake-on-LAN receive filter, which keeps watching
+  *         the link while the MCU and its MAC sleep. The station address
+  *         and SecureOn password are always written, the pattern, its byte
+  *         mask and offset only with DP83822_WOL_PATTERN. The wake indication
+  *         is level mode and stays set until DP83822_GetWolStatus(); with
+  *         Interrupt set it also raises DP83822_WOL_IT on the INTR pin.
+  *         Like the interrupt configuration it is lost on soft reset.
+  *         13 MDIO frames plus the interrupt mask, 40 more with a pattern.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pCfg: wake sources and filters, Modes = 0 disables Wake-on-LAN
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  *         DP83822_STATUS_ERROR if the configuration is invalid
+  */
+int32_t DP83822_SetWol(dp83822_Object_t *pObj, const dp83822_WolCfg_t *pCfg)
+{
+  uint16_t regs[DP83822_WOL_PATTERN_REG_NB];
+  uint32_t cfg = pCfg->Modes & DP83822_WOL_ALL, i;
+  int32_t status;
+
+  if(pCfg->Modes & ~DP83822_WOL_ALL)
+    return DP83822_STATUS_ERROR;
+
+  /* SecureOn only qualifies the magic packet */
+  if((cfg & DP83822_WOL_SECURE_ON) && !(cfg & DP83822_WOL_MAGIC))
+    return DP83822_STATUS_ERROR;
+
+  if((cfg & DP83822_WOL_PATTERN) &&
+     (pCfg->PatternMask == 0 || pCfg->PatternOffset > DP83822_RXFPATC_START))
+    return DP83822_STATUS_ERROR;
+
+  if(cfg == 0)
+  {
+    /* Stop the filter before the wake can no longer be reported */
+    if((status = DP83822_WriteExtReg(pObj, DP83822_MMD_VENDOR, DP83822_RXFCFG, DP83822_RXFCFG_WOL_OUT_CLEAR)) < 0)
+      return status;
+    pObj->WolConfig = 0;
+    return DP83822_DisableIT(pObj, DP83822_WOL_IT);
+  }
+
+  for(i = 0; i < 3U; i++)
+  {
+    regs[i]      = (uint16_t)(pCfg->Mac[2U * i] | (pCfg->Mac[2U * i + 1U] << 8));
+    regs[3U + i] = (uint16_t)(pCfg->Password[2U * i] | (pCfg->Password[2U * i + 1U] << 8));
+  }
+  if((status = DP83822_WriteExtRegs(pObj, DP83822_MMD_VENDOR, DP83822_RXFPMD1, regs, DP83822_WOL_ADDR_REG_NB)) < 0)
+    return status;
+
+  if(cfg & DP83822_WOL_PATTERN)
+  {
+    for(i = 0; i < DP83822_WOL_PATTERN_SIZE / 2U; i++)
+      regs[i] = (uint16_t)(pCfg->Pattern[2U * i] | (pCfg->Pattern[2U * i + 1U] << 8));
+    for(i = 0; i < 4U; i++)
+      regs[32U + i] = (uint16_t)(pCfg->PatternMask >> (16U * i));
+    regs[36] = (uint16_t)pCfg->PatternOffset;
+
+    if((status = DP83822_WriteExtRegs(pObj, DP83822_MMD_VENDOR, DP83822_RXFPAT1, regs,
+                                      DP83822_WOL_PATTERN_REG_NB)) < 0)
+      return status;
+  }
+
+  /* Enable with a stale indication cleared */
+  cfg |= DP83822_RXFCFG_WOL_EN | DP83822_RXFCFG_WOL_OUT_MODE;
+  if((status = DP83822_WriteExtReg(pObj, DP83822_MMD_VENDOR, DP83822_RXFCFG, cfg | DP83822_RXFCFG_WOL_OUT_CLEAR)) < 0)
+    return status;
+  pObj->WolConfig = cfg;
+
+  if(pCfg->Interrupt)
+    return DP83822_EnableIT(pObj, DP83822_WOL_IT);
+
+  return DP83822_DisableIT(pObj, DP83822_WOL_IT);
+}
+
+/**
+  * @brief  Get the cause of a wake and rearm the filter. Call it after
+  *         DP83822_GetPendingIT() returned DP83822_WOL_IT, or on resume
+  *         from a wake source the PHY does not route. A wake is logged as
+  *         DP83822_EVENT_WAKE. 8 MDIO frames, 4 without a wake.
+  * @param  pObj: device object dp83822_Object_t.
+  * @param  pCauses: pointer to hold the DP83822_WOL_xxx causes, 0 if none;
+  *         DP83822_WOL_SECURE_ON reports a magic packet with a wrong password
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_READ_ERROR if cannot read register
+  *         DP83822_STATUS_WRITE_ERROR if cannot write to register
+  */
+int32_t DP83822_GetWolStatus(dp83822_Object_t *pObj, uint32_t *pCauses)
+{
+  uint32_t rxfs = 0;
+  int32_t status;
+
+  *pCauses = 0;
+
+  if((status = DP83822_ReadExtReg(pObj, DP83822_MMD_VENDOR, DP83822_RXFS, &rxfs)) < 0)
+    return status;
+
+  rxfs &= DP83822_WOL_ALL;
+  if(rxfs == 0)
+    return DP83822_STATUS_OK;
+
+  if((status = DP83822_WriteExtReg(pObj, DP83822_MMD_VENDOR, DP83822_RXFCFG,
+                                   pObj->WolConfig | DP83822_RXFCFG_WOL_OUT_CLEAR)) < 0)
+    return status;
+
+  DP83822_LogEvent(pObj, DP83822_EVENT_WAKE, 0, rxfs);
+  *pCauses = rxfs;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Check for a DP83822 at the given address with a single PHYIDR1
+  *         read (OUI bits [18:3]), counting the probe in pObj->ProbeCount.
+  * @retval 1 if a DP83822 answered, 0 otherwise
+  */
+static uint32_t DP83822_ProbeAddr(dp83822_Object_t *pObj, uint32_t Addr)
+{
+  uint32_t reg = 0;
+
+  pObj->ProbeCount++;
+
+  if(DP83822_BusRead(pObj, Addr, DP83822_PHYI1R, &reg) < 0)
+    return 0;
+
+  return (reg == DP83822_PHYI1R_OUI_3_18);
+}
+
+/**
+  * @brief  Decode the link state from BMSR, BMCR and (autonegotiation only)
+  *         PHYSTS values.
+  */
+static int32_t DP83822_DecodeLinkState(uint32_t bsr, uint32_t bcr, uint32_t physts)
+{
+  if(!(bsr & DP83822_BMSR_LINK_STATUS))
+    return DP83822_STATUS_LINK_DOWN;
+
+  if((bcr & DP83822_BMCR_AUTONEGO_EN) == 0)
+  {
+    /* Forced mode */
+    if((bcr & DP83822_BMCR_SPEED_SELECT) && (bcr & DP83822_BMCR_DUPLEX_MODE))
+      return DP83822_STATUS_100MBITS_FULLDUPLEX;
+    else if(bcr & DP83822_BMCR_SPEED_SELECT)
+      return DP83822_STATUS_100MBITS_HALFDUPLEX;
+    else if(bcr & DP83822_BMCR_DUPLEX_MODE)
+      return DP83822_STATUS_10MBITS_FULLDUPLEX;
+    else
+      return DP83822_STATUS_10MBITS_HALFDUPLEX;
+  }
+
+  if(!(physts & DP83822_PHYSTS_AUTONEGO_DONE))
+    return DP83822_STATUS_AUTONEGO_NOTDONE;
+
+  return DP83822_DecodePhysts(physts);
+}
+
+/**
+  * @brief  Decode speed/duplex from bits [2:1] of PHYSTS.
+  */
+static int32_t DP83822_DecodePhysts(uint32_t physts)
+{
+  switch (physts & (DP83822_PHYSTS_SPEED_MASK | DP83822_PHYSTS_DUPLEX_MASK))
+  {
+    case 0U:
+      return DP83822_STATUS_100MBITS_HALFDUPLEX;
+    case DP83822_PHYSTS_DUPLEX_MASK:
+      return DP83822_STATUS_100MBITS_FULLDUPLEX;
+    case DP83822_PHYSTS_SPEED_MASK:
+      return DP83822_STATUS_10MBITS_HALFDUPLEX;
+    case (DP83822_PHYSTS_SPEED_MASK | DP83822_PHYSTS_DUPLEX_MASK):
+      return DP83822_STATUS_10MBITS_FULLDUPLEX;
+    default:
+      return DP83822_STATUS_ERROR;
+  }
+}
+
+/**
+  * @brief  Read several registers of the PHY, as one ReadBatch job when the
+  *         IO context provides it, otherwise register by register.
+  */
+static int32_t DP83822_ReadRegs(dp83822_Object_t *pObj, dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  int32_t status = DP83822_STATUS_OK;
+  uint32_t i;
+
+  if(pObj->IO.Lock && pObj->IO.Lock() < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  pObj->FrameCount += Count;
+
+  if(pObj->IO.ReadBatch)
+  {
+    if(pObj->IO.ReadBatch(pObj->DevAddr, pOps, Count) < 0)
+      status = DP83822_STATUS_READ_ERROR;
+  }
+  else
+  {
+    for(i = 0; i < Count && status == DP83822_STATUS_OK; i++)
+    {
+      if(pObj->IO.ReadReg(pObj->DevAddr, pOps[i].RegAddr, &pOps[i].RegVal) < 0)
+        status = DP83822_STATUS_READ_ERROR;
+    }
+  }
+
+  if(pObj->IO.Unlock)
+    pObj->IO.Unlock();
+
+  return status;
+}
+
+/**
+  * @brief  Write several registers of the PHY, as one WriteBatch job when
+  *         the IO context provides it, otherwise register by register.
+  */
+static int32_t DP83822_WriteRegs(dp83822_Object_t *pObj, const dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  int32_t status = DP83822_STATUS_OK;
+  uint32_t i;
+
+  if(pObj->IO.Lock && pObj->IO.Lock() < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  pObj->FrameCount += Count;
+
+  if(pObj->IO.WriteBatch)
+  {
+    if(pObj->IO.WriteBatch(pObj->DevAddr, pOps, Count) < 0)
+      status = DP83822_STATUS_WRITE_ERROR;
+  }
+  else
+  {
+    for(i = 0; i < Count && status == DP83822_STATUS_OK; i++)
+    {
+      if(pObj->IO.WriteReg(pObj->DevAddr, pOps[i].RegAddr, pOps[i].RegVal) < 0)
+        status = DP83822_STATUS_WRITE_ERROR;
+    }
+  }
+
+  if(pObj->IO.Unlock)
+    pObj->IO.Unlock();
+
+  return status;
+}
+
+/**
+  * @brief  Read one register with the shared MDIO bus held.
+  */
+static int32_t DP83822_BusRead(dp83822_Object_t *pObj, uint32_t Addr, uint32_t RegAddr, uint32_t *pVal)
+{
+  int32_t status = DP83822_STATUS_OK;
+
+  if(pObj->IO.Lock && pObj->IO.Lock() < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  pObj->FrameCount++;
+  if(pObj->IO.ReadReg(Addr, RegAddr, pVal) < 0)
+    status = DP83822_STATUS_READ_ERROR;
+
+  if(pObj->IO.Unlock)
+    pObj->IO.Unlock();
+
+  return status;
+}
+
+/**
+  * @brief  Write one register with the shared MDIO bus held.
+  */
+static int32_t DP83822_BusWrite(dp83822_Object_t *pObj, uint32_t Addr, uint32_t RegAddr, uint32_t Val)
+{
+  int32_t status = DP83822_STATUS_OK;
+
+  if(pObj->IO.Lock && pObj->IO.Lock() < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  pObj->FrameCount++;
+  if(pObj->IO.WriteReg(Addr, RegAddr, Val) < 0)
+    status = DP83822_STATUS_WRITE_ERROR;
+
+  if(pObj->IO.Unlock)
+    pObj->IO.Unlock();
+
+  return status;
+}
+
+/**
+  * @brief  Serve a control register from the shadow without MDIO access.
+  * @retval 1 if the shadow held the value, 0 if the device must be read
+  */
+static uint32_t DP83822_PeekCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t *pVal)
+{
+  dp83822_Shadow_t *shadow = &pObj->Shadow;
+
+  if(shadow->Mode == DP83822_SHADOW_ENABLED && (shadow->Valid & (1UL << Idx)))
+  {
+    *pVal = shadow->Reg[Idx];
+    shadow->SavedCount++;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+  * @brief  Store a value just read from the device into the shadow,
+  *         counting mismatches against a valid entry.
+  */
+static void DP83822_CacheCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t Val)
+{
+  dp83822_Shadow_t *shadow = &pObj->Shadow;
+  uint32_t bit = (1UL << Idx);
+
+  if(Idx == DP83822_SHADOW_BMCR)
+  {
+    DP83822_TrackLinkMode(pObj, Val);
+  }
+
+  if(shadow->Mode != DP83822_SHADOW_DISABLED)
+  {
+    if((shadow->Valid & bit) && (shadow->Reg[Idx] != (uint16_t)Val))
+    {
+      shadow->MismatchCount++;
+    }
+    shadow->Reg[Idx] = (uint16_t)Val;
+    shadow->Valid |= bit;
+  }
+}
+
+/**
+  * @brief  Read a control register, served from the shadow when enabled and
+  *         valid. In validate mode the device is always read and compared.
+  */
+static int32_t DP83822_ReadCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t *pVal)
+{
+  if(DP83822_PeekCtrl(pObj, Idx, pVal))
+    return DP83822_STATUS_OK;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_ShadowRegs[Idx], pVal) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  DP83822_CacheCtrl(pObj, Idx, *pVal);
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Write a control register and keep its shadow in sync. A soft
+  *         reset invalidates the whole shadow, self-clearing bits are not
+  *         cached.
+  */
+static int32_t DP83822_WriteCtrl(dp83822_Object_t *pObj, uint32_t Idx, uint32_t Val)
+{
+  dp83822_Shadow_t *shadow = &pObj->Shadow;
+  uint32_t bit = (1UL << Idx);
+
+  if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_ShadowRegs[Idx], Val) < 0)
+  {
+    shadow->Valid &= ~bit;
+    if(Idx == DP83822_SHADOW_BMCR)
+    {
+      pObj->LinkMode = DP83822_LINK_MODE_UNKNOWN;
+    }
+    return DP83822_STATUS_WRITE_ERROR;
+  }
+
+  if(Idx == DP83822_SHADOW_BMCR)
+  {
+    DP83822_TrackLinkMode(pObj, Val);
+  }
+
+  if(Idx == DP83822_SHADOW_BMCR && (Val & DP83822_BMCR_SOFT_RESET))
+  {
+    shadow->Valid = 0;
+  }
+  else if(shadow->Mode != DP83822_SHADOW_DISABLED)
+  {
+    if(Idx == DP83822_SHADOW_BMCR)
+    {
+      Val &= ~DP83822_BMCR_RESTART_AUTONEGO;
+    }
+    shadow->Reg[Idx] = (uint16_t)Val;
+    shadow->Valid |= bit;
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Point MMDACR/MMDAADR at an extended register and select the
+  *         data function for the following MMDAADR accesses.
+  */
+static int32_t DP83822_SetupExt(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint32_t Function)
+{
+  dp83822_RegOp_t ops[3];
+
+  DevAd &= DP83822_MMDACR_MMD_DEV_ADDR;
+
+  ops[0].RegAddr = DP83822_MMDACR;
+  ops[0].RegVal  = DP83822_MMDACR_MMD_FUNCTION_ADDR | DevAd;
+  ops[1].RegAddr = DP83822_MMDAADR;
+  ops[1].RegVal  = RegAddr & 0xFFFFU;
+  ops[2].RegAddr = DP83822_MMDACR;
+  ops[2].RegVal  = Function | DevAd;
+
+  return DP83822_WriteRegs(pObj, ops, 3);
+}
+
+/**
+  * @brief  Record the speed/duplex selection mode from a BMCR value, a soft
+  *         reset leaves it unknown.
+  */
+static void DP83822_TrackLinkMode(dp83822_Object_t *pObj, uint32_t bcr)
+{
+  if(bcr & DP83822_BMCR_SOFT_RESET)
+    pObj->LinkMode = DP83822_LINK_MODE_UNKNOWN;
+  else if(bcr & DP83822_BMCR_AUTONEGO_EN)
+    pObj->LinkMode = DP83822_LINK_MODE_AUTONEGO;
+  else
+    pObj->LinkMode = DP83822_LINK_MODE_FORCED;
+}
+
+/**
+  * @brief  Read the MISR registers holding the given flags and latch their
+  *         causes into pObj->ITPending (MISR status bits are clear-on-read).
+  */
+static int32_t DP83822_LatchIT(dp83822_Object_t *pObj, uint32_t Interrupt)
+{
+  dp83822_RegOp_t ops[2];
+  uint32_t count = 0, causes = 0, i;
+
+  if(Interrupt & DP83822_MISR1_IT_MASK)
+  {
+    ops[count].RegAddr = DP83822_MISR1;
+    ops[count++].RegVal = 0;
+  }
+  if(Interrupt & DP83822_MISR2_IT_MASK)
+  {
+    ops[count].RegAddr = DP83822_MISR2;
+    ops[count++].RegVal = 0;
+  }
+
+  if(count == 0)
+    return DP83822_STATUS_OK;
+
+  if(DP83822_ReadRegs(pObj, ops, count) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  for(i = 0; i < count; i++)
+  {
+    if(ops[i].RegAddr == DP83822_MISR1)
+      causes |= (ops[i].RegVal & DP83822_MISR_INT_STAT_MASK) >> 8;
+    else
+      causes |= (ops[i].RegVal & DP83822_MISR_INT_STAT_MASK);
+  }
+
+  pObj->ITPending |= causes;
+
+  if(causes & DP83822_EVENT_IT_MASK)
+  {
+    DP83822_LogEvent(pObj, DP83822_EVENT_INTERRUPT, 0, causes & DP83822_EVENT_IT_MASK);
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Write the interrupt enables of the MISR registers touched by
+  *         Changed and gate the interrupt output in PHYSCR. MISR enables are
+  *         written from pObj->ITEnabled, so no clear-on-read status is lost.
+  */
+static int32_t DP83822_WriteITMask(dp83822_Object_t *pObj, uint32_t ITEnabled, uint32_t Changed)
+{
+  dp83822_RegOp_t ops[2];
+  uint32_t count = 0, val = 0;
+
+  if(Changed & DP83822_MISR1_IT_MASK)
+  {
+    ops[count].RegAddr = DP83822_MISR1;
+    ops[count++].RegVal = ITEnabled & DP83822_MISR_INT_EN_MASK;
+  }
+  if(Changed & DP83822_MISR2_IT_MASK)
+  {
+    ops[count].RegAddr = DP83822_MISR2;
+    ops[count++].RegVal = (ITEnabled >> 8) & DP83822_MISR_INT_EN_MASK;
+  }
+
+  if(count && DP83822_WriteRegs(pObj, ops, count) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  if((pObj->ITEnabled == 0) != (ITEnabled == 0))
+  {
+    if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_PHYSCR, &val) < 0)
+      return DP83822_STATUS_READ_ERROR;
+
+    if(ITEnabled)
+      val |= (DP83822_PHYSCR_INTEN | DP83822_PHYSCR_INT_OE);
+    else
+      val &= ~(DP83822_PHYSCR_INTEN | DP83822_PHYSCR_INT_OE);
+
+    if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_PHYSCR, val) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+  }
+
+  pObj->ITEnabled = ITEnabled;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Read and decode the link state, see DP83822_GetLinkState().
+  */
+static int32_t DP83822_ReadLinkState(dp83822_Object_t *pObj)
+{
+  dp83822_RegOp_t ops[3] = { { DP83822_BMSR, 0 }, { DP83822_PHYSTS, 0 }, { DP83822_BMCR, 0 } };
+  uint32_t bcr = 0;
+
+  if(pObj->IO.ReadBatch)
+  {
+    uint32_t shadowed = DP83822_PeekCtrl(pObj, DP83822_SHADOW_BMCR, &bcr);
+
+    if(DP83822_ReadRegs(pObj, ops, shadowed ? 2U : 3U) < 0)
+      return DP83822_STATUS_READ_ERROR;
+
+    /* PHYSTS error latches clear on read, keep them for the status calls */
+    pObj->PhystsLatch |= ops[1].RegVal & DP83822_PHYSTS_LATCH_MASK;
+
+    if(!shadowed)
+    {
+      bcr = ops[2].RegVal;
+      DP83822_CacheCtrl(pObj, DP83822_SHADOW_BMCR, bcr);
+    }
+    return DP83822_DecodeLinkState(ops[0].RegVal, bcr, ops[1].RegVal);
+  }
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_BMSR, &ops[0].RegVal) < 0)
+    return DP83822_STATUS_READ_ERROR;
+  if(!(ops[0].RegVal & DP83822_BMSR_LINK_STATUS))
+    return DP83822_STATUS_LINK_DOWN;
+
+  if(DP83822_ReadCtrl(pObj, DP83822_SHADOW_BMCR, &bcr) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  if(bcr & DP83822_BMCR_AUTONEGO_EN)
+  {
+    /* Auto-negotiated, read PHYSTS */
+    if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_PHYSTS, &ops[1].RegVal) < 0)
+      return DP83822_STATUS_READ_ERROR;
+    pObj->PhystsLatch |= ops[1].RegVal & DP83822_PHYSTS_LATCH_MASK;
+  }
+
+  return DP83822_DecodeLinkState(ops[0].RegVal, bcr, ops[1].RegVal);
+}
+
+/**
+  * @brief  Append an event to the link event log, overwriting the oldest
+  *         undrained event when the log is full.
+  */
+static void DP83822_LogEvent(dp83822_Object_t *pObj, uint32_t Type, int32_t LinkState, uint32_t Interrupt)
+{
+  dp83822_EventLog_t *log = &pObj->Events;
+  dp83822_Event_t *event = &log->Event[log->Head & (DP83822_EVENT_LOG_SIZE - 1U)];
+
+  event->Tick      = (uint32_t)pObj->IO.GetTick();
+  event->Type      = (uint8_t)Type;
+  event->LinkState = (int8_t)LinkState;
+  event->Interrupt = (uint16_t)Interrupt;
+
+  log->Head++;
+  if(log->Count < DP83822_EVENT_LOG_SIZE)
+    log->Count++;
+  else
+    log->Lost++;
+}
+
+/**
+  * @brief  Log the difference between a polled link state and the previous
+  *         one. Only resolved speed/duplex states count as link up, read
+  *         errors are not recorded.
+  */
+static void DP83822_LogLinkState(dp83822_Object_t *pObj, int32_t LinkState)
+{
+  int32_t last = pObj->Events.LastLinkState;
+  uint32_t up_now, up_last;
+
+  if(LinkState < 0 || LinkState == last)
+    return;
+
+  up_now  = DP83822_IS_LINK_UP(LinkState);
+  up_last = DP83822_IS_LINK_UP(last);
+
+  if(up_now && up_last)
+    DP83822_LogEvent(pObj, DP83822_EVENT_SPEED_DUPLEX, LinkState, 0);
+  else if(up_now)
+    DP83822_LogEvent(pObj, DP83822_EVENT_LINK_UP, LinkState, 0);
+  else if(up_last)
+    DP83822_LogEvent(pObj, DP83822_EVENT_LINK_DOWN, LinkState, 0);
+
+  pObj->Events.LastLinkState = LinkState;
+}
+
+/**
+  * @brief  BMCR speed/duplex bits forcing a link state.
+  */
+static int32_t DP83822_ForcedCtrl(uint32_t LinkState, uint32_t *pBcr)
+{
+  switch(LinkState)
+  {
+    case DP83822_STATUS_100MBITS_FULLDUPLEX:
+      *pBcr = (DP83822_BMCR_SPEED_SELECT | DP83822_BMCR_DUPLEX_MODE);
+      break;
+    case DP83822_STATUS_100MBITS_HALFDUPLEX:
+      *pBcr = DP83822_BMCR_SPEED_SELECT;
+      break;
+    case DP83822_STATUS_10MBITS_FULLDUPLEX:
+      *pBcr = DP83822_BMCR_DUPLEX_MODE;
+      break;
+    default:
+      return DP83822_STATUS_ERROR;
+  }
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Write pObj->FastTimers to the CR1 fast timer bits.
+  */
+static int32_t DP83822_WriteFastTimers(dp83822_Object_t *pObj)
+{
+  uint32_t val = 0;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_CR1, &val) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  val = (val & ~DP83822_FAST_ALL) | pObj->FastTimers;
+
+  if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_CR1, val) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Write the CR3 fast link down criteria of pObj->FastLinkDown.
+  */
+static int32_t DP83822_WriteFastLinkDown(dp83822_Object_t *pObj)
+{
+  uint32_t val = 0;
+
+  if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_CR3, &val) < 0)
+    return DP83822_STATUS_READ_ERROR;
+
+  val = (val & ~DP83822_CR3_FLD_MASK) | pObj->FastLinkDown;
+
+  if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_CR3, val) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Every later frame can drop the preamble if the PHY accepts it.
+  */
+static void DP83822_CheckPreamble(dp83822_Object_t *pObj, uint32_t bsr)
+{
+  if(!pObj->PreambleSuppressed && pObj->IO.SetPreamble && (bsr & DP83822_BMSR_MF_PREAMBLE))
+  {
+    pObj->PreambleSuppressed = (pObj->IO.SetPreamble(pObj->DevAddr, 1) >= 0);
+  }
+}
+
+/**
+  * @brief  Derive packets, checked bits and error rate from the run time.
+  *         The DP83822 has no packet counter, the generator sends back to
+  *         back at line rate. Each errored byte counts as one bit error.
+  */
+static void DP83822_SelfTestRate(dp83822_Object_t *pObj, uint32_t ElapsedMs)
+{
+  dp83822_SelfTest_t *test = &pObj->SelfTest;
+  dp83822_SelfTestResult_t *result = &test->Result;
+  uint64_t ber;
+
+  result->ElapsedMs = ElapsedMs;
+  result->Packets   = (uint64_t)ElapsedMs * DP83822_BIST_LINE_RATE_KBPS / test->FrameBits;
+  result->Bits      = result->Packets * test->PacketLength * 8U;
+
+  if(result->Bits == 0)
+  {
+    result->BerE12 = 0;
+    return;
+  }
+
+  /* ErrorBytes * 10^12 stays within 64 bits below 1.8e7 errors */
+  if(result->ErrorBytes >= 18000000U)
+    ber = 0xFFFFFFFFU;
+  else
+    ber = result->ErrorBytes * 1000000000000ULL / result->Bits;
+  result->BerE12 = (ber > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)ber;
+}
+
+/**
+  * @brief  Stop the generator, leave the loopback point and restore BMCR.
+  */
+static int32_t DP83822_StopSelfTest(dp83822_Object_t *pObj)
+{
+  pObj->SelfTest.State = DP83822_BIST_STATE_IDLE;
+
+  if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_BISCR, 0) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  if(DP83822_WriteCtrl(pObj, DP83822_SHADOW_BMCR, pObj->SelfTest.SavedBcr) < 0)
+    return DP83822_STATUS_WRITE_ERROR;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Classify the first significant reflection of one pair.
+  */
+static void DP83822_DecodeCablePair(const uint16_t *pRegs, uint32_t Pair, dp83822_CablePair_t *pResult)
+{
+  uint32_t peak, idx, shift, amplitude;
+
+  pResult->Fault      = DP83822_CABLE_MATCH;
+  pResult->DistanceCm = 0;
+  pResult->Amplitude  = 0;
+
+  for(peak = 0; peak < DP83822_CDLRR_NB; peak++)
+  {
+    idx   = Pair * DP83822_CDLRR_NB + peak;
+    shift = (idx & 1U) * 8U;
+    amplitude = (pRegs[DP83822_CDLRR_NB + idx / 2U] >> shift) & DP83822_CDLAR_AMPLITUDE;
+
+    if(amplitude >= DP83822_TDR_PEAK_THRESHOLD)
+    {
+      pResult->Fault      = ((pRegs[2U * DP83822_CDLRR_NB] >> idx) & 1U) ? DP83822_CABLE_OPEN : DP83822_CABLE_SHORT;
+      pResult->DistanceCm = ((pRegs[idx / 2U] >> shift) & DP83822_CDLRR_LOCATION) * DP83822_TDR_CM_PER_STEP;
+      pResult->Amplitude  = amplitude;
+      return;
+    }
+  }
+}
+
+/**
+  * @brief  A profile may not touch the registers owned by the driver, nor
+  *         read the clear-on-read status and counter registers whose content
+  *         the driver accumulates.
+  * @retval 1 if every entry may be applied
+  */
+static uint32_t DP83822_ProfileValid(const dp83822_ProfileEntry_t *pEntries, uint32_t Count)
+{
+  uint32_t i;
+
+  for(i = 0; i < Count; i++)
+  {
+    if(pEntries[i].DevAd == DP83822_PROFILE_BASIC)
+    {
+      if(pEntries[i].Reg > DP83822_MAX_REG_ADDR)
+        return 0;
+
+      switch(pEntries[i].Reg)
+      {
+        /* Link, interrupt, fast timers, fast link down and extended access */
+        case DP83822_BMCR:
+        case DP83822_CR1:
+        case DP83822_CR3:
+        case DP83822_PHYSCR:
+        case DP83822_MMDACR:
+        case DP83822_MMDAADR:
+        /* Clear on read */
+        case DP83822_BMSR:
+        case DP83822_PHYSTS:
+        case DP83822_MISR1:
+        case DP83822_MISR2:
+        case DP83822_FCSCR:
+        case DP83822_RECR:
+        case DP83822_BICSR1:
+          return 0;
+        default:
+          break;
+      }
+    }
+    else if(pEntries[i].DevAd > DP83822_MMDACR_MMD_DEV_ADDR)
+    {
+      return 0;
+    }
+    /* EEE advertisement of DP83822_SetEee(), LPI latches and wake error counter */
+    else if((pEntries[i].DevAd == DP83822_MMD_AUTONEGO && pEntries[i].Reg == DP83822_EEE_ADVERTISE) ||
+            (pEntries[i].DevAd == DP83822_MMD_PCS &&
+             (pEntries[i].Reg == DP83822_PCS_STATUS1 || pEntries[i].Reg == DP83822_EEE_WAKE_ERRORS)))
+    {
+      return 0;
+    }
+    /* Wake-on-LAN receive filter of DP83822_SetWol() */
+    else if(pEntries[i].DevAd == DP83822_MMD_VENDOR &&
+            pEntries[i].Reg >= DP83822_RXFCFG && pEntries[i].Reg <= DP83822_RXFPATC)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+  * @brief  Read, optionally write the differences of, and check a profile.
+  *         Runs of basic registers are handled DP83822_PROFILE_CHUNK at a
+  *         time with batched transactions.
+  */
+static int32_t DP83822_RunProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count,
+                                  uint32_t Write, dp83822_ProfileResult_t *pResult)
+{
+  dp83822_RegOp_t ops[DP83822_PROFILE_CHUNK];
+  dp83822_RegOp_t wops[DP83822_PROFILE_CHUNK];
+  uint8_t wslot[DP83822_PROFILE_CHUNK];
+  dp83822_ProfileResult_t result;
+  const dp83822_ProfileEntry_t *entry;
+  uint32_t frames = pObj->FrameCount, i = 0, n, w, k, j, want;
+  int32_t status;
+
+  result.Written       = 0;
+  result.Mismatches    = 0;
+  result.FirstMismatch = Count;
+
+  /* Every exit below goes through the result write at the end */
+  status = DP83822_ProfileValid(pEntries, Count) ? DP83822_STATUS_OK : DP83822_STATUS_ERROR;
+
+  while(status == DP83822_STATUS_OK && i < Count)
+  {
+    entry = &pEntries[i];
+
+    if(entry->DevAd != DP83822_PROFILE_BASIC)
+    {
+      /* Extended register: the data function leaves MMDAADR on it for the write and read-back */
+      if(DP83822_SetupExt(pObj, entry->DevAd, entry->Reg, DP83822_MMDACR_MMD_FUNCTION_DATA) < 0)
+      {
+        status = DP83822_STATUS_WRITE_ERROR;
+        break;
+      }
+      if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_MMDAADR, &n) < 0)
+      {
+        status = DP83822_STATUS_READ_ERROR;
+        break;
+      }
+
+      want = (n & ~(uint32_t)entry->Mask) | (entry->Value & entry->Mask);
+      if(Write && want != n)
+      {
+        if(DP83822_BusWrite(pObj, pObj->DevAddr, DP83822_MMDAADR, want) < 0)
+        {
+          status = DP83822_STATUS_WRITE_ERROR;
+          break;
+        }
+        if(DP83822_BusRead(pObj, pObj->DevAddr, DP83822_MMDAADR, &n) < 0)
+        {
+          status = DP83822_STATUS_READ_ERROR;
+          break;
+        }
+        result.Written++;
+      }
+      if((n ^ entry->Value) & entry->Mask)
+        DP83822_ProfileMismatch(&result, i);
+
+      i++;
+      continue;
+    }
+
+    /* Run of basic registers */
+    for(n = 0; n < DP83822_PROFILE_CHUNK && i + n < Count && pEntries[i + n].DevAd == DP83822_PROFILE_BASIC; n++)
+    {
+      ops[n].RegAddr = pEntries[i + n].Reg;
+      ops[n].RegVal  = 0;
+    }
+    if(DP83822_ReadRegs(pObj, ops, n) < 0)
+    {
+      status = DP83822_STATUS_READ_ERROR;
+      break;
+    }
+
+    for(k = 0, w = 0; k < n; k++)
+    {
+      entry = &pEntries[i + k];
+      want = (ops[k].RegVal & ~(uint32_t)entry->Mask) | (entry->Value & entry->Mask);
+      wslot[k] = DP83822_PROFILE_CHUNK;
+
+      if(Write && want != ops[k].RegVal)
+      {
+        /* One write per register, entries on the same register fold into it in table order */
+        j = 0;
+        while(j < w && wops[j].RegAddr != entry->Reg)
+          j++;
+        if(j == w)
+          wops[w++].RegAddr = entry->Reg;
+        wops[j].RegVal = want;
+        wslot[k] = (uint8_t)j;
+
+        for(j = k + 1; j < n; j++)
+        {
+          if(ops[j].RegAddr == entry->Reg)
+            ops[j].RegVal = want;
+        }
+      }
+      else if((ops[k].RegVal ^ entry->Value) & entry->Mask)
+      {
+        DP83822_ProfileMismatch(&result, i + k);
+      }
+    }
+
+    if(w != 0)
+    {
+      if(DP83822_WriteRegs(pObj, wops, w) < 0)
+      {
+        status = DP83822_STATUS_WRITE_ERROR;
+        break;
+      }
+      result.Written += w;
+
+      /* Read back only what was written */
+      for(k = 0; k < w; k++)
+        ops[k].RegAddr = wops[k].RegAddr;
+      if(DP83822_ReadRegs(pObj, ops, w) < 0)
+      {
+        status = DP83822_STATUS_READ_ERROR;
+        break;
+      }
+
+      for(k = 0; k < n; k++)
+      {
+        entry = &pEntries[i + k];
+        if(wslot[k] < w && ((ops[wslot[k]].RegVal ^ entry->Value) & entry->Mask))
+          DP83822_ProfileMismatch(&result, i + k);
+      }
+    }
+
+    i += n;
+  }
+
+  result.Frames = pObj->FrameCount - frames;
+  if(pResult)
+    *pResult = result;
+
+  if(status != DP83822_STATUS_OK)
+    return status;
+  return (result.Mismatches != 0) ? DP83822_STATUS_ERROR : DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Count a profile entry that does not hold its value.
+  */
+static void DP83822_ProfileMismatch(dp83822_ProfileResult_t *pResult, uint32_t Idx)
+{
+  if(pResult->Mismatches++ == 0)
+    pResult->FirstMismatch = Idx;
+}
+
+/**
+  * @brief  Debounce a polled link state, see DP83822_SetDebounce().
+  * @retval Link state to report, read errors pass unchanged
+  */
+static int32_t DP83822_FilterLinkState(dp83822_Object_t *pObj, int32_t LinkState)
+{
+  dp83822_Debounce_t *db = &pObj->Debounce;
+  uint32_t now, up, window;
+
+  if(LinkState < 0 || (db->UpMs == 0 && db->DownMs == 0 && db->FlapLimit == 0))
+    return LinkState;
+
+  now = (uint32_t)pObj->IO.GetTick();
+  up  = DP83822_IS_LINK_UP(LinkState);
+
+  /* A burst of raw drops takes the link down until it holds up for HoldDownMs */
+  if(db->RawUp && !up)
+  {
+    db->Drops++;
+    if(now - db->FlapTick > DP83822_FLAP_WINDOW_MS)
+    {
+      db->FlapTick = now;
+      db->Flaps = 0;
+    }
+    if(db->FlapLimit != 0 && ++db->Flaps >= db->FlapLimit && !db->HoldDown)
+    {
+      db->HoldDown = 1;
+      db->HoldDowns++;
+      db->Pending = 0;
+      db->Stable  = DP83822_STATUS_LINK_DOWN;
+    }
+  }
+  db->RawUp = up;
+
+  if(db->Stable == 0 || up == (uint32_t)DP83822_IS_LINK_UP(db->Stable))
+  {
+    if(db->Pending)
+    {
+      db->Pending = 0;
+      db->Suppressed++;
+    }
+    db->Stable = LinkState;
+    return LinkState;
+  }
+
+  if(!db->Pending)
+  {
+    db->Pending = 1;
+    db->PendingTick = now;
+  }
+
+  window = up ? (db->HoldDown ? db->HoldDownMs : db->UpMs) : db->DownMs;
+  if(now - db->PendingTick < window)
+    return db->Stable;
+
+  db->Pending = 0;
+  db->Stable  = LinkState;
+  if(up)
+    db->HoldDown = 0;
+  return LinkState;
+}
+
+/**
+  * @brief  Write the EEE advertisement of pObj->EeeMode.
+  */
+static int32_t DP83822_WriteEee(dp83822_Object_t *pObj)
+{
+  return DP83822_WriteExtReg(pObj, DP83822_MMD_AUTONEGO, DP83822_EEE_ADVERTISE,
+                             (pObj->EeeMode == DP83822_EEE_ENABLED) ? DP83822_EEE_100BASE_TX : 0U);
+}
+
+/**
+  * @brief  Count the LPI entries, exits and time of one path between two
+  *         PCS status samples. LPI both entered and left between the samples
+  *         counts once with no time.
+  */
+static void DP83822_CountLpi(uint32_t Prev, uint32_t Status, uint32_t Ind, uint32_t Rcvd, uint32_t ElapsedMs,
+                             uint32_t *pEntries, uint32_t *pExits, uint32_t *pLpiMs)
+{
+  uint32_t was = (Prev & Ind) != 0, is = (Status & Ind) != 0;
+  uint32_t entered = !was && (is || (Status & Rcvd));
+
+  *pEntries = entered;
+  *pExits   = (was || entered) && !is;
+  *pLpiMs   = (ElapsedMs * (was + is)) / 2U;
 }
@@ -28,24 +28,24 @@
 #define DP83822_BMSR           ((uint16_t)0x0001U)
 #define DP83822_PHYI1R         ((uint16_t)0x0002U)
 #define DP83822_PHYI2R         ((uint16_t)0x0003U)
-//#define DP83822_ANAR          ((uint16_t)0x0004U)
-//#define DP83822_ANLPAR        ((uint16_t)0x0005U)
-//#define DP83822_ANER          ((uint16_t)0x0006U)
+#define DP83822_ANAR           ((uint16_t)0x0004U)
+#define DP83822_ANLPAR         ((uint16_t)0x0005U)
+#define DP83822_ANER           ((uint16_t)0x0006U)
 //#define DP83822_ANNPTR        ((uint16_t)0x0007U)
 //#define DP83822_ANNPRR        ((uint16_t)0x0008U)
-//#define DP83822_MMDACR        ((uint16_t)0x000DU)
-//#define DP83822_MMDAADR       ((uint16_t)0x000EU)
+#define DP83822_CR1            ((uint16_t)0x0009U)
+#define DP83822_CR3            ((uint16_t)0x000BU)
+#define DP83822_MMDACR         ((uint16_t)0x000DU)
+#define DP83822_MMDAADR        ((uint16_t)0x000EU)
 //#define DP83822_ENCTR         ((uint16_t)0x0010U)
 //
 //
 //#define DP83822_TPDCR         ((uint16_t)0x0018U)
-//#define DP83822_TCSR          ((uint16_t)0x0019U)
 //#define DP83822_SECR          ((uint16_t)0x001AU)
 //#define DP83822_SCSIR         ((uint16_t)0x001BU)
-//#define DP83822_CLR           ((uint16_t)0x001CU)
 //
 //
-#define DP83822_PHYSTS        0x0010U
+#define DP83822_PHYSTS         0x0010U
 //
 ///* BMCR Bit Definition */
 #define DP83822_BMCR_SOFT_RESET         ((uint16_t)0x8000U)
@@ -66,6 +66,7 @@
 //#define DP83822_BMSR_100BASE_T2_FD      ((uint16_t)0x0400U)
 //#define DP83822_BMSR_100BASE_T2_HD      ((uint16_t)0x0200U)
 //#define DP83822_BMSR_EXTENDED_STATUS    ((uint16_t)0x0100U)
+#define DP83822_BMSR_MF_PREAMBLE        ((uint16_t)0x0040U)  /* Accepts preamble-suppressed frames */
 //#define DP83822_BMSR_AUTONEGO_CPLT      ((uint16_t)0x0020U)
 //#define DP83822_BMSR_REMOTE_FAULT       ((uint16_t)0x0010U)
 //#define DP83822_BMSR_AUTONEGO_ABILITY   ((uint16_t)0x0008U)
@@ -77,46 +78,50 @@
 #define DP83822_PHYI1R_OUI_3_18        ((uint16_t)0x2000U)
 //
 ///* PHYID2R Bit Definition */
-//#define DP83822_PHYI2R_OUI_19_24       ((uint16_t)0x08U)  /* bits [15:10] */
-//#define DP83822_PHYI2R_MODEL_NBR       ((uint16_t)0x0FU)  /* bits [9:4]  */
-//#define DP83822_PHYI2R_REVISION_NBR    ((uint16_t)0x000FU)  /* bits [3:0]  */
+#define DP83822_PHYI2R_OUI_19_24       ((uint16_t)0xFC00U)  /* bits [15:10] */
+#define DP83822_PHYI2R_MODEL_NBR       ((uint16_t)0x03F0U)  /* bits [9:4]  */
+#define DP83822_PHYI2R_REVISION_NBR    ((uint16_t)0x000FU)  /* bits [3:0]  */
+#define DP83822_PHYI2R_ID              ((uint16_t)0xA240U)  /* OUI bits [24:19] and model 0x24 */
 //
 ///* ANAR Bit Definition */
-//#define DP83822_ANAR_NEXT_PAGE               ((uint16_t)0x8000U)
-//#define DP83822_ANAR_REMOTE_FAULT            ((uint16_t)0x2000U)
-//#define DP83822_ANAR_PAUSE_OPERATION         ((uint16_t)0x0C00U)
-//#define DP83822_ANAR_PO_NOPAUSE              ((uint16_t)0x0000U)
-//#define DP83822_ANAR_PO_SYMMETRIC_PAUSE      ((uint16_t)0x0400U)
-//#define DP83822_ANAR_PO_ASYMMETRIC_PAUSE     ((uint16_t)0x0800U)
-//#define DP83822_ANAR_PO_ADVERTISE_SUPPORT    ((uint16_t)0x0C00U)
-//#define DP83822_ANAR_100BASE_TX_FD           ((uint16_t)0x0100U)
-//#define DP83822_ANAR_100BASE_TX              ((uint16_t)0x0080U)
-//#define DP83822_ANAR_10BASE_T_FD             ((uint16_t)0x0040U)
-//#define DP83822_ANAR_10BASE_T                ((uint16_t)0x0020U)
-//#define DP83822_ANAR_SELECTOR_FIELD          ((uint16_t)0x000FU)
+#define DP83822_ANAR_NEXT_PAGE               ((uint16_t)0x8000U)
+#define DP83822_ANAR_REMOTE_FAULT            ((uint16_t)0x2000U)
+#define DP83822_ANAR_PAUSE_OPERATION         ((uint16_t)0x0C00U)
+#define DP83822_ANAR_PO_NOPAUSE              ((uint16_t)0x0000U)
+#define DP83822_ANAR_PO_SYMMETRIC_PAUSE      ((uint16_t)0x0400U)
+#define DP83822_ANAR_PO_ASYMMETRIC_PAUSE     ((uint16_t)0x0800U)
+#define DP83822_ANAR_PO_ADVERTISE_SUPPORT    ((uint16_t)0x0C00U)
+#define DP83822_ANAR_100BASE_TX_FD           ((uint16_t)0x0100U)
+#define DP83822_ANAR_100BASE_TX              ((uint16_t)0x0080U)
+#define DP83822_ANAR_10BASE_T_FD             ((uint16_t)0x0040U)
+#define DP83822_ANAR_10BASE_T                ((uint16_t)0x0020U)
+#define DP83822_ANAR_SELECTOR_FIELD          ((uint16_t)0x000FU)
+#define DP83822_ANAR_SELECTOR_IEEE802_3      ((uint16_t)0x0001U)
+#define DP83822_ANAR_ADVERTISE_MASK          ((uint16_t)0x0DE0U)  /* Pause and technology abilities */
+#define DP83822_ANAR_TECHNOLOGY_MASK         ((uint16_t)0x01E0U)
 //
 ///* ANLPAR Bit Definition */
-//#define DP83822_ANLPAR_NEXT_PAGE            ((uint16_t)0x8000U)
-//#define DP83822_ANLPAR_REMOTE_FAULT         ((uint16_t)0x2000U)
-//#define DP83822_ANLPAR_PAUSE_OPERATION      ((uint16_t)0x0C00U)
-//#define DP83822_ANLPAR_PO_NOPAUSE           ((uint16_t)0x0000U)
-//#define DP83822_ANLPAR_PO_SYMMETRIC_PAUSE   ((uint16_t)0x0400U)
-//#define DP83822_ANLPAR_PO_ASYMMETRIC_PAUSE  ((uint16_t)0x0800U)
-//#define DP83822_ANLPAR_PO_ADVERTISE_SUPPORT ((uint16_t)0x0C00U)
-//#define DP83822_ANLPAR_100BASE_TX_FD        ((uint16_t)0x0100U)
-//#define DP83822_ANLPAR_100BASE_TX           ((uint16_t)0x0080U)
-//#define DP83822_ANLPAR_10BASE_T_FD          ((uint16_t)0x0040U)
-//#define DP83822_ANLPAR_10BASE_T             ((uint16_t)0x0020U)
-//#define DP83822_ANLPAR_SELECTOR_FIELD       ((uint16_t)0x000FU)
+#define DP83822_ANLPAR_NEXT_PAGE            ((uint16_t)0x8000U)
+#define DP83822_ANLPAR_REMOTE_FAULT         ((uint16_t)0x2000U)
+#define DP83822_ANLPAR_PAUSE_OPERATION      ((uint16_t)0x0C00U)
+#define DP83822_ANLPAR_PO_NOPAUSE           ((uint16_t)0x0000U)
+#define DP83822_ANLPAR_PO_SYMMETRIC_PAUSE   ((uint16_t)0x0400U)
+#define DP83822_ANLPAR_PO_ASYMMETRIC_PAUSE  ((uint16_t)0x0800U)
+#define DP83822_ANLPAR_PO_ADVERTISE_SUPPORT ((uint16_t)0x0C00U)
+#define DP83822_ANLPAR_100BASE_TX_FD        ((uint16_t)0x0100U)
+#define DP83822_ANLPAR_100BASE_TX           ((uint16_t)0x0080U)
+#define DP83822_ANLPAR_10BASE_T_FD          ((uint16_t)0x0040U)
+#define DP83822_ANLPAR_10BASE_T             ((uint16_t)0x0020U)
+#define DP83822_ANLPAR_SELECTOR_FIELD       ((uint16_t)0x000FU)
 //
 ///* ANER Bit Definition */
-//#define DP83822_ANER_RX_NP_LOCATION_ABLE    ((uint16_t)0x0040U)
-//#define DP83822_ANER_RX_NP_STORAGE_LOCATION ((uint16_t)0x0020U)
-//#define DP83822_ANER_PARALLEL_DETECT_FAULT  ((uint16_t)0x0010U)
-//#define DP83822_ANER_LP_NP_ABLE             ((uint16_t)0x0008U)
-//#define DP83822_ANER_NP_ABLE                ((uint16_t)0x0004U)
-//#define DP83822_ANER_PAGE_RECEIVED          ((uint16_t)0x0002U)
-//#define DP83822_ANER_LP_AUTONEG_ABLE        ((uint16_t)0x0001U)
+#define DP83822_ANER_RX_NP_LOCATION_ABLE    ((uint16_t)0x0040U)
+#define DP83822_ANER_RX_NP_STORAGE_LOCATION ((uint16_t)0x0020U)
+#define DP83822_ANER_PARALLEL_DETECT_FAULT  ((uint16_t)0x0010U)
+#define DP83822_ANER_LP_NP_ABLE             ((uint16_t)0x0008U)
+#define DP83822_ANER_NP_ABLE                ((uint16_t)0x0004U)
+#define DP83822_ANER_PAGE_RECEIVED          ((uint16_t)0x0002U)
+#define DP83822_ANER_LP_AUTONEG_ABLE        ((uint16_t)0x0001U)
 //
 ///* ANNPTR Bit Definition */
 //#define DP83822_ANNPTR_NEXT_PAGE         ((uint16_t)0x8000U)
@@ -133,11 +138,73 @@
 //#define DP83822_ANNPRR_TOGGLE            ((uint16_t)0x0800U)
 //#define DP83822_ANNPRR_MESSAGGE_CODE     ((uint16_t)0x07FFU)
 //
+///* CR1 Bit Definition */
+#define DP83822_CR1_FAST_AUTO_MDIX           ((uint16_t)0x0040U)
+#define DP83822_CR1_ROBUST_AUTO_MDIX         ((uint16_t)0x0020U)
+#define DP83822_CR1_FAST_AUTONEGO_EN         ((uint16_t)0x0010U)
+#define DP83822_CR1_FAST_AUTONEGO_SEL        ((uint16_t)0x000CU)  /* Break link / link fail inhibit / AN wait timers */
+#define DP83822_CR1_FAST_RXDV_DETECT         ((uint16_t)0x0002U)
+//
+///* CR3 Bit Definition */
+#define DP83822_CR3_FLD_MASK                 ((uint16_t)0x000FU)  /* Fast link down criteria */
+//
 ///* MMD Access Control Register */
-//#define DP83822_MMDACR_MMD_FUNCTION       ((uint16_t)0xC000U)
-//#define DP83822_MMDACR_MMD_FUNCTION_ADDR  ((uint16_t)0x0000U)
-//#define DP83822_MMDACR_MMD_FUNCTION_DATA  ((uint16_t)0x4000U)
-//#define DP83822_MMDACR_MMD_DEV_ADDR       ((uint16_t)0x001FU)
+#define DP83822_MMDACR_MMD_FUNCTION          ((uint16_t)0xC000U)
+#define DP83822_MMDACR_MMD_FUNCTION_ADDR     ((uint16_t)0x0000U)
+#define DP83822_MMDACR_MMD_FUNCTION_DATA     ((uint16_t)0x4000U)
+#define DP83822_MMDACR_MMD_FUNCTION_DATA_PI  ((uint16_t)0x8000U)  /* Post increment on read and write */
+#define DP83822_MMDACR_MMD_FUNCTION_DATA_PIW ((uint16_t)0xC000U)  /* Post increment on write only */
+#define DP83822_MMDACR_MMD_DEV_ADDR          ((uint16_t)0x001FU)
+
+/* MMD device addresses */
+#define DP83822_MMD_PCS                      ((uint32_t)0x0003U)
+#define DP83822_MMD_AUTONEGO                 ((uint32_t)0x0007U)
+#define DP83822_MMD_VENDOR                   ((uint32_t)0x001FU)  /* DP83822 extended registers */
+
+/* Cable diagnostic results, DP83822_MMD_VENDOR. Peak n of a pair sits in
+   the low (odd n) or high (even n) byte, TX peaks 1..5 then RX peaks 1..5 */
+#define DP83822_CDLRR1                       ((uint16_t)0x0180U)  /* Peak locations, 5 registers */
+#define DP83822_CDLAR1                       ((uint16_t)0x0185U)  /* Peak amplitudes, 5 registers */
+#define DP83822_CDLAR6                       ((uint16_t)0x018AU)  /* Peak signs */
+#define DP83822_CDLRR_LOCATION               ((uint16_t)0x00FFU)
+#define DP83822_CDLAR_AMPLITUDE              ((uint16_t)0x007FU)
+#define DP83822_CDLAR6_TX_SIGN               ((uint16_t)0x001FU)  /* 1 = positive reflection, TX peaks 1..5 */
+#define DP83822_CDLAR6_RX_SIGN               ((uint16_t)0x03E0U)  /* Same for RX peaks 1..5 */
+#define DP83822_CDLRR_NB                     5U
+#define DP83822_CABLE_DIAG_REG_NB            11U                  /* CDLRR1..CDLAR6, one burst */
+
+/* Adaptive equalizer status, DP83822_MMD_VENDOR, valid with a 100BASE-TX link */
+#define DP83822_DSP_EQ_STATUS                ((uint16_t)0x0466U)
+#define DP83822_DSP_EQ_SETTING               ((uint16_t)0x00FFU)
+
+/* Energy Efficient Ethernet, IEEE 802.3 clause 45 registers */
+#define DP83822_PCS_STATUS1                  ((uint16_t)0x0001U)  /* DP83822_MMD_PCS */
+#define DP83822_PCS_STATUS1_TX_LPI_RCVD      ((uint16_t)0x0800U)  /* Transmit LPI since last read, latched high */
+#define DP83822_PCS_STATUS1_RX_LPI_RCVD      ((uint16_t)0x0400U)  /* Receive LPI since last read, latched high */
+#define DP83822_PCS_STATUS1_TX_LPI_IND       ((uint16_t)0x0200U)  /* Transmit path in LPI */
+#define DP83822_PCS_STATUS1_RX_LPI_IND       ((uint16_t)0x0100U)  /* Receive path in LPI */
+#define DP83822_EEE_CAPABILITY               ((uint16_t)0x0014U)  /* DP83822_MMD_PCS */
+#define DP83822_EEE_WAKE_ERRORS              ((uint16_t)0x0016U)  /* DP83822_MMD_PCS, clear on read */
+#define DP83822_EEE_ADVERTISE                ((uint16_t)0x003CU)  /* DP83822_MMD_AUTONEGO */
+#define DP83822_EEE_LP_ABILITY               ((uint16_t)0x003DU)  /* DP83822_MMD_AUTONEGO, EEE_ADVERTISE format */
+#define DP83822_EEE_100BASE_TX               ((uint16_t)0x0002U)  /* Capability, advertisement and partner bit */
+
+/* Wake-on-LAN receive filter, DP83822_MMD_VENDOR. Byte pairs are stored low byte first */
+#define DP83822_RXFCFG                       ((uint16_t)0x04A0U)  /* Receive filter configuration */
+#define DP83822_RXFS                         ((uint16_t)0x04A1U)  /* Receive filter status, DP83822_WOL_xxx causes */
+#define DP83822_RXFPMD1                      ((uint16_t)0x04A2U)  /* Station address, 3 registers */
+#define DP83822_RXFSOP1                      ((uint16_t)0x04A5U)  /* SecureOn password, 3 registers */
+#define DP83822_RXFPAT1                      ((uint16_t)0x04A8U)  /* Pattern bytes, 32 registers */
+#define DP83822_RXFPBM1                      ((uint16_t)0x04C8U)  /* Pattern byte mask, 4 registers */
+#define DP83822_RXFPATC                      ((uint16_t)0x04CCU)  /* Pattern start offset */
+#define DP83822_RXFCFG_WOL_OUT_CLEAR         ((uint16_t)0x0800U)  /* Clear the wake indication, self clearing */
+#define DP83822_RXFCFG_WOL_OUT_MODE          ((uint16_t)0x0100U)  /* Level instead of pulse indication */
+#define DP83822_RXFCFG_WOL_EN                ((uint16_t)0x0080U)
+#define DP83822_RXFCFG_WAKE_MASK             ((uint16_t)0x0037U)  /* DP83822_WOL_xxx wake sources */
+#define DP83822_RXFS_SFD_ERROR               ((uint16_t)0x0080U)  /* Frame dropped for a bad start of frame */
+#define DP83822_RXFPATC_START                ((uint16_t)0x003FU)
+#define DP83822_WOL_ADDR_REG_NB              6U                   /* RXFPMD1..RXFSOP3, one burst */
+#define DP83822_WOL_PATTERN_REG_NB           37U                  /* RXFPAT1..RXFPATC, one burst */
 //
 ///* MCSR Bit Definition */
 //
@@ -171,56 +238,88 @@
 //#define DP83822_TPDCR_PATTERN_HIGH             ((uint16_t)0x0FC0U)
 //#define DP83822_TPDCR_PATTERN_LOW              ((uint16_t)0x003FU)
 //
-///* TCSR Bit Definition */
-//#define DP83822_TCSR_TDR_ENABLE           ((uint16_t)0x8000U)
-//#define DP83822_TCSR_TDR_AD_FILTER_ENABLE ((uint16_t)0x4000U)
-//#define DP83822_TCSR_TDR_CH_CABLE_TYPE    ((uint16_t)0x0600U)
-//#define DP83822_TCSR_TDR_CH_CABLE_DEFAULT ((uint16_t)0x0000U)
-//#define DP83822_TCSR_TDR_CH_CABLE_SHORTED ((uint16_t)0x0200U)
-//#define DP83822_TCSR_TDR_CH_CABLE_OPEN    ((uint16_t)0x0400U)
-//#define DP83822_TCSR_TDR_CH_CABLE_MATCH   ((uint16_t)0x0600U)
-//#define DP83822_TCSR_TDR_CH_STATUS        ((uint16_t)0x0100U)
-//#define DP83822_TCSR_TDR_CH_LENGTH        ((uint16_t)0x00FFU)
-//
 ///* SCSIR Bit Definition */
 //#define DP83822_SCSIR_AUTO_MDIX_ENABLE    ((uint16_t)0x8000U)
 //#define DP83822_SCSIR_CHANNEL_SELECT      ((uint16_t)0x2000U)
 //#define DP83822_SCSIR_SQE_DISABLE         ((uint16_t)0x0800U)
 //#define DP83822_SCSIR_XPOLALITY           ((uint16_t)0x0010U)
 //
-///* CLR Bit Definition */
-//#define DP83822_CLR_CABLE_LENGTH          ((uint16_t)0xF000U)
-//
-///* IMR / ISFR Bit Definition */
-//#define DP83822_INT_8       ((uint16_t)0x0100U)
-//#define DP83822_INT_7       ((uint16_t)0x0080U)
-//#define DP83822_INT_6       ((uint16_t)0x0040U)
-//#define DP83822_INT_5       ((uint16_t)0x0020U)
-//#define DP83822_INT_4       ((uint16_t)0x0010U)
-//#define DP83822_INT_3       ((uint16_t)0x0008U)
-//#define DP83822_INT_2       ((uint16_t)0x0004U)
-//#define DP83822_INT_1       ((uint16_t)0x0002U)
-//
-//#define DP83822_PHYSTS                0x0010U     /* PHY Status Register */
 //#define DP83822_PHYSTS_PHY_ADDR_MASK  0x001FU     /* PHY Address Mask */
 //
-//#define DP83822_PHYSCR                0x0011U     /* PHY Special Control/Status Register */
-//
-//#define DP83822_MISR1                 0x0012U     /* MII Interrupt Status Register 1 */
-//#define DP83822_MISR1_LINK_STAT_CHG   0x0020U     /* Link Status Change */
-//
-//#define DP83822_MISR2                 0x0013U     /* MII Interrupt Status Register 2 */
-//
-//#define DP83822_IMR                   0x0014U     /* Interrupt Mask Register */
-//#define DP83822_IMR_LINK_STAT_CHG_EN  0x0020U     /* Link Status Change Interrupt Enable */
-//
-//#define DP83822_PHYCR                 0x0019U     /* PHY Control Register */
-//
-///* PHYSCSR Bit Definition */
-#define DP83822_PHYSTS_AUTONEGO_DONE 0x0010U  /* bit 4 */
-#define DP83822_PHYSTS_DUPLEX_MASK   0x0004U  /* bit 2 */
-#define DP83822_PHYSTS_SPEED_MASK    0x0002U  /* bit 1 */
-//#define DP83822_PHYSTS_LINK_STATUS   0x0001U  /* bit 0 */
+#define DP83822_PHYSCR                0x0011U     /* PHY Specific Control Register */
+#define DP83822_MISR1                 0x0012U     /* MII Interrupt Status Register 1 */
+#define DP83822_MISR2                 0x0013U     /* MII Interrupt Status Register 2 */
+#define DP83822_FCSCR                 0x0014U     /* False Carrier Sense Counter Register */
+#define DP83822_RECR                  0x0015U     /* Receive Error Counter Register */
+#define DP83822_BISCR                 0x0016U     /* BIST Control Register */
+#define DP83822_RCSR                  0x0017U     /* RMII and Status Register */
+#define DP83822_LEDCR                 0x0018U     /* LED Control Register */
+#define DP83822_PHYCR                 0x0019U     /* PHY Control Register */
+#define DP83822_BICSR1                0x001BU     /* BIST Control and Status Register 1 */
+#define DP83822_BICSR2                0x001CU     /* BIST Control and Status Register 2 */
+#define DP83822_CDCR                  0x001EU     /* Cable Diagnostic Control Register */
+//
+///* PHYSCR Bit Definition */
+#define DP83822_PHYSCR_INT_POL        0x0008U     /* INTn active high when set */
+#define DP83822_PHYSCR_INTEN          0x0002U     /* Interrupt enable */
+#define DP83822_PHYSCR_INT_OE         0x0001U     /* INTR/PWRDN pin is interrupt output */
+//
+///* RCSR / LEDCR / PHYCR Bit Definition */
+#define DP83822_RCSR_RMII_CLK_SEL     0x0080U     /* RMII reference clock 25 MHz instead of 50 MHz */
+#define DP83822_RCSR_RMII_MODE        0x0020U     /* RMII instead of MII */
+#define DP83822_LEDCR_BLINK_RATE      0x0600U     /* LED blink rate */
+#define DP83822_PHYCR_MDIX_EN         0x8000U     /* Auto MDI/MDI-X */
+#define DP83822_PHYCR_FORCE_MDIX      0x4000U     /* MDI-X when auto MDI/MDI-X is disabled */
+#define DP83822_PHYCR_LED_CFG         0x0020U     /* LED mode */
+#define DP83822_PHYCR_PHY_ADDR        0x001FU     /* Strapped PHY address, read only */
+//
+///* FCSCR / RECR Bit Definition: clear on read, saturate at their maximum */
+#define DP83822_FCSCR_FCSCNT          0x00FFU
+#define DP83822_RECR_RXERCNT          0xFFFFU
+//
+///* BISCR Bit Definition */
+#define DP83822_BISCR_ERR_CNT_MODE    0x4000U     /* Error counter restarts instead of stopping at its maximum */
+#define DP83822_BISCR_PACKET_GEN_EN   0x1000U     /* PRBS packet generator and checker */
+#define DP83822_BISCR_PRBS_LOCK       0x0800U     /* PRBS checker locked on the received stream */
+#define DP83822_BISCR_PRBS_SYNC_LOSS  0x0400U     /* PRBS checker lost sync, latched */
+#define DP83822_BISCR_PACKET_GEN_BUSY 0x0200U     /* Packet generator transmitting */
+#define DP83822_BISCR_LOOPBACK_MASK   0x001FU     /* Loopback point, DP83822_BIST_LOOPBACK_xxx */
+//
+///* BICSR1 / BICSR2 Bit Definition */
+#define DP83822_BICSR1_ERR_COUNT      0xFF00U     /* Errored bytes seen by the PRBS checker, clear on read */
+#define DP83822_BICSR1_IPG_LENGTH     0x00FFU     /* Inter-packet gap in bytes */
+#define DP83822_BICSR2_PACKET_LENGTH  0x07FFU     /* Generated packet length in bytes */
+//
+///* CDCR Bit Definition */
+#define DP83822_CDCR_DIAG_START       0x8000U     /* Start the TDR measurement, self clearing */
+#define DP83822_CDCR_DIAG_DONE        0x0002U     /* Results valid */
+#define DP83822_CDCR_DIAG_FAIL        0x0001U     /* Measurement could not complete */
+//
+///* MISR1 / MISR2 Bit Definition: enables in bits [7:0], latched status in bits [15:8] */
+#define DP83822_MISR_INT_EN_MASK      0x00FFU
+#define DP83822_MISR_INT_STAT_MASK    0xFF00U
+//
+///* PHYSTS Bit Definition */
+#define DP83822_PHYSTS_MDIX_MODE        0x4000U  /* bit 14 */
+#define DP83822_PHYSTS_RX_ERROR_LATCH   0x2000U  /* bit 13, clear on read */
+#define DP83822_PHYSTS_POLARITY         0x1000U  /* bit 12, inverted polarity */
+#define DP83822_PHYSTS_FALSE_CARRIER    0x0800U  /* bit 11, clear on read */
+#define DP83822_PHYSTS_SIGNAL_DETECT    0x0400U  /* bit 10 */
+#define DP83822_PHYSTS_DESCRAMBLER_LOCK 0x0200U  /* bit 9 */
+#define DP83822_PHYSTS_PAGE_RECEIVED    0x0100U  /* bit 8 */
+#define DP83822_PHYSTS_MII_INTERRUPT    0x0080U  /* bit 7 */
+#define DP83822_PHYSTS_REMOTE_FAULT     0x0040U  /* bit 6 */
+#define DP83822_PHYSTS_JABBER_DETECT    0x0020U  /* bit 5 */
+#define DP83822_PHYSTS_AUTONEGO_DONE    0x0010U  /* bit 4 */
+#define DP83822_PHYSTS_LOOPBACK         0x0008U  /* bit 3 */
+#define DP83822_PHYSTS_DUPLEX_MASK      0x0004U  /* bit 2 */
+#define DP83822_PHYSTS_SPEED_MASK       0x0002U  /* bit 1 */
+#define DP83822_PHYSTS_LINK_STATUS      0x0001U  /* bit 0 */
+#define DP83822_PHYSTS_STATE_MASK       (DP83822_PHYSTS_MDIX_MODE | DP83822_PHYSTS_POLARITY | \
+                                         DP83822_PHYSTS_REMOTE_FAULT | DP83822_PHYSTS_AUTONEGO_DONE | \
+                                         DP83822_PHYSTS_LOOPBACK | DP83822_PHYSTS_DUPLEX_MASK | \
+                                         DP83822_PHYSTS_SPEED_MASK | DP83822_PHYSTS_LINK_STATUS)
+#define DP83822_PHYSTS_LATCH_MASK       (DP83822_PHYSTS_RX_ERROR_LATCH | DP83822_PHYSTS_FALSE_CARRIER)
 //
 //
 //#define DP83822_PHYSCSR_10BT_HD          ((uint16_t)0x0004U)
@@ -241,18 +340,207 @@
 #define  DP83822_STATUS_10MBITS_FULLDUPLEX    ((int32_t) 4)
 #define  DP83822_STATUS_10MBITS_HALFDUPLEX    ((int32_t) 5)
 #define  DP83822_STATUS_AUTONEGO_NOTDONE      ((int32_t) 6)
-//
-///* Interrupt flags */
-//#define  DP83822_WOL_IT                        DP83822_INT_8
-//#define  DP83822_ENERGYON_IT                   DP83822_INT_7
-//#define  DP83822_AUTONEGO_COMPLETE_IT          DP83822_INT_6
-//#define  DP83822_REMOTE_FAULT_IT               DP83822_INT_5
-//#define  DP83822_LINK_DOWN_IT                  DP83822_INT_4
-//#define  DP83822_AUTONEGO_LP_ACK_IT            DP83822_INT_3
-//#define  DP83822_PARALLEL_DETECTION_FAULT_IT   DP83822_INT_2
-//#define  DP83822_AUTONEGO_PAGE_RECEIVED_IT     DP83822_INT_1
-//
-//#define DP83822_TIMEOUT_VALUE ((uint32_t)2000) /*!< Timeout for polling loops in ms */
+#define  DP83822_STATUS_BUSY                  ((int32_t) 7)
+//
+///* Interrupt flags: bits [7:0] are MISR1 sources, bits [15:8] are MISR2 sources */
+#define  DP83822_RX_ERR_HALF_FULL_IT           ((uint32_t)0x0001U)
+#define  DP83822_FALSE_CARRIER_HALF_FULL_IT    ((uint32_t)0x0002U)
+#define  DP83822_AUTONEGO_COMPLETE_IT          ((uint32_t)0x0004U)
+#define  DP83822_DUPLEX_CHANGE_IT              ((uint32_t)0x0008U)
+#define  DP83822_SPEED_CHANGE_IT               ((uint32_t)0x0010U)
+#define  DP83822_LINK_STATUS_CHANGE_IT         ((uint32_t)0x0020U)
+#define  DP83822_ENERGYON_IT                   ((uint32_t)0x0040U)
+#define  DP83822_LINK_QUALITY_IT               ((uint32_t)0x0080U)
+#define  DP83822_JABBER_DETECT_IT              ((uint32_t)0x0100U)
+#define  DP83822_WOL_IT                        ((uint32_t)0x0200U)
+#define  DP83822_SLEEP_MODE_IT                 ((uint32_t)0x0400U)
+#define  DP83822_MDI_CROSSOVER_IT              ((uint32_t)0x0800U)
+#define  DP83822_LOOPBACK_FIFO_IT              ((uint32_t)0x1000U)
+#define  DP83822_AUTONEGO_PAGE_RECEIVED_IT     ((uint32_t)0x2000U)
+#define  DP83822_AUTONEGO_ERROR_IT             ((uint32_t)0x4000U)
+#define  DP83822_EEE_ERROR_IT                  ((uint32_t)0x8000U)
+
+#define  DP83822_MISR1_IT_MASK                 ((uint32_t)0x00FFU)
+#define  DP83822_MISR2_IT_MASK                 ((uint32_t)0xFF00U)
+#define  DP83822_ALL_IT                        (DP83822_MISR1_IT_MASK | DP83822_MISR2_IT_MASK)
+
+#define DP83822_TIMEOUT_VALUE      ((uint32_t)2000) /*!< Timeout for polling loops in ms */
+#define DP83822_LINK_TIMEOUT_VALUE ((uint32_t)5000) /*!< Timeout for initial link wait in ms */
+
+/* Control register shadow modes */
+#define DP83822_SHADOW_DISABLED       ((uint32_t)0U)  /*!< Every control access reads the device */
+#define DP83822_SHADOW_ENABLED        ((uint32_t)1U)  /*!< Read-modify-write served from the shadow */
+#define DP83822_SHADOW_VALIDATE       ((uint32_t)2U)  /*!< Read-through, count shadow/device mismatches */
+
+/* Control register shadow entries */
+#define DP83822_SHADOW_BMCR           0U
+#define DP83822_SHADOW_PHYSCR         1U
+#define DP83822_SHADOW_NB             2U
+
+/* Speed/duplex selection mode last written to BMCR */
+#define DP83822_LINK_MODE_UNKNOWN     ((uint32_t)0U)
+#define DP83822_LINK_MODE_AUTONEGO    ((uint32_t)1U)
+#define DP83822_LINK_MODE_FORCED      ((uint32_t)2U)
+
+/* Retries of a lock-free snapshot read before reporting DP83822_STATUS_BUSY */
+#define DP83822_PUB_READ_RETRIES      ((uint32_t)8U)
+
+/* Memory barrier ordering the published link snapshot, hardware and compiler barrier.
+   GCC/armclang, IAR and armcc are covered, other toolchains must define it. */
+#ifndef DP83822_MEMORY_BARRIER
+#if defined(__GNUC__)
+#define DP83822_MEMORY_BARRIER()      __sync_synchronize()
+#elif defined(__ICCARM__)
+#include <intrinsics.h>
+#define DP83822_MEMORY_BARRIER()      __DMB()    /* Intrinsic, also a compiler barrier */
+#elif defined(__CC_ARM)
+#define DP83822_MEMORY_BARRIER()      do { __schedule_barrier(); __dmb(0xF); __schedule_barrier(); } while(0)
+#else
+#error "DP83822_MEMORY_BARRIER() is not defined for this toolchain, the published status needs it"
+#endif
+#endif
+
+/* Extended register burst chunk, bounds the stack used by DP83822_ReadExtRegs() */
+#define DP83822_EXT_BURST_CHUNK       8U
+
+/* Hardware error counters, dp83822_Counters_t Saturated flags */
+#define DP83822_COUNTER_RX_ERROR      ((uint32_t)0x0001U)  /*!< RECR */
+#define DP83822_COUNTER_FALSE_CARRIER ((uint32_t)0x0002U)  /*!< FCSCR */
+#define DP83822_COUNTER_NB            2U                   /*!< MDIO frames per sample, one job */
+
+/* Fast link down criteria, CR3 bits [3:0] */
+#define DP83822_FLD_ENERGY_LOST       ((uint32_t)0x0001U)  /*!< Signal energy lost */
+#define DP83822_FLD_MLT3_ERRORS       ((uint32_t)0x0002U)  /*!< MLT3 coding errors */
+#define DP83822_FLD_RX_ERRORS         ((uint32_t)0x0004U)  /*!< Receive errors */
+#define DP83822_FLD_DESCRAMBLER_LOSS  ((uint32_t)0x0008U)  /*!< Descrambler sync loss */
+#define DP83822_FLD_ALL               ((uint32_t)0x000FU)
+
+/* Register profile entries, dp83822_ProfileEntry_t DevAd of a basic register */
+#define DP83822_PROFILE_BASIC         ((uint16_t)0x0000U)
+#define DP83822_PROFILE_CHUNK         8U                   /*!< Basic registers per batched read, bounds the stack */
+#define DP83822_PROFILE_REG(Reg, Mask, Value)         { DP83822_PROFILE_BASIC, (Reg), (Mask), (Value) }
+#define DP83822_PROFILE_EXT(DevAd, Reg, Mask, Value)  { (DevAd), (Reg), (Mask), (Value) }
+
+/* Fast bring-up timer options, CR1 bits */
+#define DP83822_FAST_AUTO_MDIX        ((uint32_t)0x0040U)  /*!< Fast auto-MDIX resolution */
+#define DP83822_FAST_AUTONEGO         ((uint32_t)0x0010U)  /*!< Fast autonegotiation timers */
+#define DP83822_FAST_AUTONEGO_80MS    ((uint32_t)0x0000U)  /*!< Break link 80 ms, link fail inhibit 50 ms, AN wait 35 ms */
+#define DP83822_FAST_AUTONEGO_120MS   ((uint32_t)0x0004U)  /*!< Break link 120 ms, link fail inhibit 75 ms, AN wait 50 ms */
+#define DP83822_FAST_AUTONEGO_240MS   ((uint32_t)0x0008U)  /*!< Break link 240 ms, link fail inhibit 150 ms, AN wait 100 ms */
+#define DP83822_FAST_RXDV_DETECT      ((uint32_t)0x0002U)  /*!< Early RX_DV assertion */
+#define DP83822_FAST_ALL              (DP83822_FAST_AUTO_MDIX | DP83822_FAST_AUTONEGO | \
+                                       DP83822_CR1_FAST_AUTONEGO_SEL | DP83822_FAST_RXDV_DETECT)
+
+/* Forced mode deadline of the fast start before falling back to autonegotiation */
+#define DP83822_FAST_START_TIMEOUT_VALUE ((uint32_t)500U)
+
+/* Flow control resolved by autonegotiation, dp83822_AutoNego_t Pause */
+#define DP83822_PAUSE_TX              ((uint32_t)0x0001U)  /*!< MAC may send PAUSE frames */
+#define DP83822_PAUSE_RX              ((uint32_t)0x0002U)  /*!< MAC must honour received PAUSE frames */
+
+/* Self-test loopback points, BISCR bits [4:0] */
+#define DP83822_BIST_LOOPBACK_PCS_INPUT  ((uint32_t)0x0001U)  /*!< Near end, MII to PCS input */
+#define DP83822_BIST_LOOPBACK_PCS_OUTPUT ((uint32_t)0x0002U)  /*!< Near end, PCS output */
+#define DP83822_BIST_LOOPBACK_DIGITAL    ((uint32_t)0x0004U)  /*!< Near end, digital front end */
+#define DP83822_BIST_LOOPBACK_ANALOG     ((uint32_t)0x0008U)  /*!< Near end, analog front end, needs a terminated MDI */
+#define DP83822_BIST_LOOPBACK_REVERSE    ((uint32_t)0x0010U)  /*!< Far end, link partner loops the stream back */
+
+/* Self-test defaults and limits */
+#define DP83822_BIST_PACKET_LENGTH    ((uint32_t)1518U)
+#define DP83822_BIST_IPG_LENGTH       ((uint32_t)12U)
+#define DP83822_BIST_LINE_RATE_KBPS   ((uint32_t)100000U)  /*!< Self-test runs at 100 Mbit/s */
+#define DP83822_BIST_MAX_DURATION     ((uint32_t)0x7FFFFFFFU)  /*!< ms, longest run the tick arithmetic allows */
+
+/* Self-test phases */
+#define DP83822_BIST_STATE_IDLE       ((uint32_t)0U)
+#define DP83822_BIST_STATE_RUNNING    ((uint32_t)1U)
+
+/* Cable diagnostic pairs */
+#define DP83822_CABLE_PAIR_TX         0U
+#define DP83822_CABLE_PAIR_RX         1U
+#define DP83822_CABLE_PAIR_NB         2U
+
+/* Cable diagnostic fault types */
+#define DP83822_CABLE_UNKNOWN         ((uint32_t)0U)
+#define DP83822_CABLE_MATCH           ((uint32_t)1U)  /*!< Terminated, no reflection */
+#define DP83822_CABLE_OPEN            ((uint32_t)2U)  /*!< Positive reflection */
+#define DP83822_CABLE_SHORT           ((uint32_t)3U)  /*!< Negative reflection */
+
+/* Cable diagnostic scaling and limits */
+#define DP83822_TDR_TIMEOUT_VALUE     ((uint32_t)100U) /*!< ms for the TDR measurement to complete */
+#define DP83822_TDR_PEAK_THRESHOLD    ((uint32_t)10U)  /*!< Smallest peak amplitude taken as a reflection */
+#define DP83822_TDR_CM_PER_STEP       ((uint32_t)48U)  /*!< cm per peak location step, NVP 0.64 at 200 MHz */
+#ifndef DP83822_CABLE_CM_PER_EQ_STEP
+#define DP83822_CABLE_CM_PER_EQ_STEP  ((uint32_t)100U) /*!< cm per equalizer step, calibrate for the cable type */
+#endif
+
+/* Poll scheduler */
+#ifndef DP83822_SCHED_MAX_PORTS
+#define DP83822_SCHED_MAX_PORTS       8U
+#endif
+#if DP83822_SCHED_MAX_PORTS > 32
+#error "DP83822_SCHED_MAX_PORTS must not exceed 32, DP83822_SchedRun() reports changes in a 32-bit mask"
+#endif
+#define DP83822_SCHED_ALL_PORTS       0xFFU                 /*!< DP83822_SchedGetStats() totals */
+#define DP83822_SCHED_MIN_INTERVAL    ((uint32_t)10U)      /*!< Default fast poll period in ms */
+#define DP83822_SCHED_MAX_INTERVAL    ((uint32_t)1000U)    /*!< Default stable poll period in ms */
+#ifndef DP83822_MDIO_FRAME_NS
+#define DP83822_MDIO_FRAME_NS         ((uint32_t)25600U)   /*!< 64 MDC clocks at 2.5 MHz, halved without preamble */
+#endif
+
+/* EEE modes, DP83822_SetEee() */
+#define DP83822_EEE_DEFAULT           ((uint32_t)0U)       /*!< Advertisement left at the PHY default */
+#define DP83822_EEE_DISABLED          ((uint32_t)1U)
+#define DP83822_EEE_ENABLED           ((uint32_t)2U)       /*!< Advertise EEE at 100BASE-TX */
+
+/* Wake-on-LAN sources, dp83822_WolCfg_t Modes and DP83822_GetWolStatus() causes */
+#define DP83822_WOL_MAGIC             ((uint32_t)0x0001U)  /*!< Magic packet to the station address */
+#define DP83822_WOL_PATTERN           ((uint32_t)0x0002U)  /*!< Frame matching the masked pattern */
+#define DP83822_WOL_BROADCAST         ((uint32_t)0x0004U)  /*!< Any broadcast frame */
+#define DP83822_WOL_UNICAST           ((uint32_t)0x0010U)  /*!< Any frame to the station address */
+#define DP83822_WOL_SECURE_ON         ((uint32_t)0x0020U)  /*!< Modes: magic packet must carry the password.
+                                                                Causes: a magic packet had a wrong password */
+#define DP83822_WOL_ALL               ((uint32_t)0x0037U)
+#define DP83822_WOL_PATTERN_SIZE      64U
+
+/* 802.3az wake time of 100BASE-TX: a frame queued during LPI waits this long at most */
+#define DP83822_EEE_TW_SYS_TX_US      ((uint32_t)30U)
+
+/* Link debounce: raw link drops within this window count towards the hold-down */
+#ifndef DP83822_FLAP_WINDOW_MS
+#define DP83822_FLAP_WINDOW_MS        ((uint32_t)10000U)
+#endif
+
+/* Link event log depth, a power of two */
+#ifndef DP83822_EVENT_LOG_SIZE
+#define DP83822_EVENT_LOG_SIZE        16U
+#endif
+#if (DP83822_EVENT_LOG_SIZE == 0) || ((DP83822_EVENT_LOG_SIZE & (DP83822_EVENT_LOG_SIZE - 1U)) != 0)
+#error "DP83822_EVENT_LOG_SIZE must be a power of two, the event ring is indexed with a mask"
+#endif
+
+/* Link event types */
+#define DP83822_EVENT_LINK_UP         ((uint32_t)1U)  /*!< Polled link came up, LinkState holds speed/duplex */
+#define DP83822_EVENT_LINK_DOWN       ((uint32_t)2U)  /*!< Polled link went down */
+#define DP83822_EVENT_SPEED_DUPLEX    ((uint32_t)3U)  /*!< Polled speed/duplex changed while the link stayed up */
+#define DP83822_EVENT_AUTONEGO_START  ((uint32_t)4U)  /*!< Autonegotiation (re)started by the driver */
+#define DP83822_EVENT_RESET           ((uint32_t)5U)  /*!< Soft reset issued by the driver */
+#define DP83822_EVENT_INTERRUPT       ((uint32_t)6U)  /*!< Link related causes drained from MISR1, see Interrupt */
+#define DP83822_EVENT_WAKE            ((uint32_t)7U)  /*!< Wake-on-LAN frame, Interrupt holds the DP83822_WOL_xxx causes */
+
+/* Interrupt causes recorded as DP83822_EVENT_INTERRUPT */
+#define DP83822_EVENT_IT_MASK         (DP83822_LINK_STATUS_CHANGE_IT | DP83822_SPEED_CHANGE_IT | \
+                                       DP83822_DUPLEX_CHANGE_IT | DP83822_AUTONEGO_COMPLETE_IT | \
+                                       DP83822_ENERGYON_IT)
+
+/* Init state machine phases */
+#define DP83822_INIT_STATE_IDLE       ((uint32_t)0U)
+#define DP83822_INIT_STATE_RESET      ((uint32_t)1U)
+#define DP83822_INIT_STATE_AUTONEGO   ((uint32_t)2U)
+#define DP83822_INIT_STATE_LINK_WAIT  ((uint32_t)3U)
+#define DP83822_INIT_STATE_DONE       ((uint32_t)4U)
+#define DP83822_INIT_STATE_ERROR      ((uint32_t)5U)
+#define DP83822_INIT_STATE_FAST_START ((uint32_t)6U)  /*!< Forced speed/duplex, autonegotiation on timeout */
 
 /* Exported types ------------------------------------------------------------*/
 typedef int32_t  (*dp83822_Init_Func)     (void);
@@ -260,39 +548,371 @@ typedef int32_t  (*dp83822_DeInit_Func)   (void);
 typedef int32_t  (*dp83822_ReadReg_Func)  (uint32_t, uint32_t, uint32_t *);
 typedef int32_t  (*dp83822_WriteReg_Func) (uint32_t, uint32_t, uint32_t);
 typedef int32_t  (*dp83822_GetTick_Func)  (void);
+typedef int32_t  (*dp83822_Lock_Func)     (void);
+typedef int32_t  (*dp83822_Unlock_Func)   (void);
+typedef int32_t  (*dp83822_SetPreamble_Func) (uint32_t, uint32_t);
+
+/* One register access of a batched MDIO transaction */
+typedef struct
+{
+  uint32_t RegAddr;
+  uint32_t RegVal;   /*!< Value to write, or filled in by a read */
+} dp83822_RegOp_t;
+
+typedef int32_t  (*dp83822_ReadBatch_Func)  (uint32_t, dp83822_RegOp_t *, uint32_t);
+typedef int32_t  (*dp83822_WriteBatch_Func) (uint32_t, const dp83822_RegOp_t *, uint32_t);
 
 typedef struct 
 {                   
-  dp83822_Init_Func      Init;
-  dp83822_DeInit_Func    DeInit;
-  dp83822_WriteReg_Func  WriteReg;
-  dp83822_ReadReg_Func   ReadReg;
-  dp83822_GetTick_Func   GetTick;
+  dp83822_Init_Func       Init;
+  dp83822_DeInit_Func     DeInit;
+  dp83822_WriteReg_Func   WriteReg;
+  dp83822_ReadReg_Func    ReadReg;
+  dp83822_GetTick_Func    GetTick;
+  dp83822_ReadBatch_Func  ReadBatch;   /*!< Optional: read (DevAddr, ops, count) in one MDIO job */
+  dp83822_WriteBatch_Func WriteBatch;  /*!< Optional: write (DevAddr, ops, count) in one MDIO job */
+  dp83822_Lock_Func       Lock;        /*!< Optional: acquire the MDIO bus shared with other PHYs */
+  dp83822_Unlock_Func     Unlock;      /*!< Optional: release the MDIO bus */
+  dp83822_SetPreamble_Func SetPreamble; /*!< Optional: (DevAddr, Suppress) drop the 32-bit MDIO preamble */
 } dp83822_IOCtx_t;
 
+typedef struct
+{
+  uint32_t            Mode;                     /*!< DP83822_SHADOW_xxx mode */
+  uint32_t            Valid;                    /*!< Bit n set when Reg[n] matches the device */
+  uint16_t            Reg[DP83822_SHADOW_NB];   /*!< Cached control registers */
+  uint32_t            SavedCount;               /*!< MDIO reads saved by shadow hits */
+  uint32_t            MismatchCount;            /*!< Validate mode: shadow differed from device */
+} dp83822_Shadow_t;
+
+/* Link status decoded from a single PHYSTS read */
+typedef struct
+{
+  int32_t             LinkState;        /*!< DP83822_STATUS_LINK_DOWN .. DP83822_STATUS_AUTONEGO_NOTDONE */
+  uint16_t            Physts;           /*!< Raw PHYSTS value */
+  uint8_t             Link;
+  uint8_t             Speed100;         /*!< 1: 100 Mbit/s, 0: 10 Mbit/s */
+  uint8_t             FullDuplex;
+  uint8_t             ForcedMode;       /*!< Speed/duplex forced, autonegotiation disabled */
+  uint8_t             AutoNegoDone;
+  uint8_t             Mdix;             /*!< MDI pairs swapped (MDI-X) */
+  uint8_t             PolarityInverted;
+  uint8_t             RemoteFault;
+  uint8_t             Jabber;
+  uint8_t             FalseCarrier;     /*!< False carrier seen since last read */
+  uint8_t             RxError;          /*!< Receive error seen since last read */
+  uint8_t             SignalDetect;
+  uint8_t             DescramblerLock;
+} dp83822_Status_t;
+
+/* Link status published to any number of lock-free readers (seqlock) */
+typedef struct
+{
+  volatile uint32_t   Sequence;         /*!< Odd while the single writer updates the snapshot */
+  volatile uint32_t   Generation;       /*!< Incremented whenever the published link changes */
+  uint32_t            Tick;             /*!< GetTick of the last publication */
+  dp83822_Status_t    Status;
+} dp83822_LinkPub_t;
+
+/* Autonegotiation result */
+typedef struct
+{
+  int32_t             LinkState;        /*!< Resolved DP83822_STATUS_xxx, DP83822_STATUS_AUTONEGO_NOTDONE while negotiating */
+  uint32_t            Pause;            /*!< DP83822_PAUSE_xxx, full duplex only */
+  uint8_t             PartnerAutoNego;  /*!< 0: partner does not negotiate, link state is parallel detected */
+  uint8_t             ParallelDetectFault;
+  uint16_t            Advertised;       /*!< ANAR */
+  uint16_t            Partner;          /*!< ANLPAR */
+  uint16_t            Expansion;        /*!< ANER */
+} dp83822_AutoNego_t;
+
+/* Self-test configuration */
+typedef struct
+{
+  uint32_t            Loopback;         /*!< DP83822_BIST_LOOPBACK_xxx */
+  uint32_t            PacketLength;     /*!< Bytes per packet, 0 for DP83822_BIST_PACKET_LENGTH */
+  uint32_t            IpgLength;        /*!< Inter-packet gap bytes, 0 for DP83822_BIST_IPG_LENGTH */
+  uint32_t            DurationMs;       /*!< Run time, or 0 to derive it from PacketCount */
+  uint32_t            PacketCount;      /*!< Packets to send when DurationMs is 0 */
+} dp83822_SelfTestCfg_t;
+
+/* Self-test result, bit counts are derived from the line rate and run time */
+typedef struct
+{
+  uint64_t            Packets;          /*!< Packets sent */
+  uint64_t            Bits;             /*!< Payload bits checked */
+  uint64_t            ErrorBytes;       /*!< Errored bytes counted by the PRBS checker */
+  uint32_t            BerE12;           /*!< Bit errors per 10^12 bits, lower bound (one bit per errored byte) */
+  uint32_t            ElapsedMs;
+  uint8_t             Locked;           /*!< PRBS checker locked, 0 means the loopback path is broken */
+  uint8_t             SyncLoss;         /*!< PRBS checker lost sync during the run */
+  uint8_t             Saturated;        /*!< Error counter found at its maximum, ErrorBytes is a lower bound */
+} dp83822_SelfTestResult_t;
+
+/* Self-test run state */
+typedef struct
+{
+  uint32_t            State;            /*!< DP83822_BIST_STATE_xxx */
+  uint32_t            StartTick;
+  uint32_t            DurationMs;
+  uint32_t            SavedBcr;         /*!< BMCR restored when the test ends */
+  uint32_t            FrameBits;        /*!< Packet plus gap and preamble, in bits */
+  uint32_t            PacketLength;
+  dp83822_SelfTestResult_t Result;
+} dp83822_SelfTest_t;
+
+/* EEE resolution */
+typedef struct
+{
+  uint8_t             Capable;          /*!< The PHY supports EEE at 100BASE-TX */
+  uint8_t             Advertised;       /*!< EEE advertised to the partner */
+  uint8_t             PartnerAdvertised;/*!< Partner advertised EEE, valid after autonegotiation */
+  uint8_t             Active;           /*!< Both advertise and the link is 100BASE-TX full duplex */
+  uint32_t            WakeUs;           /*!< Wake time added to a frame sent during LPI, 0 if not active */
+} dp83822_Eee_t;
+
+/* LPI counts of a sample, or totals since init */
+typedef struct
+{
+  uint32_t            TxEntries;        /*!< Transmit LPI periods entered, a lower bound, see DP83822_GetLpiStats() */
+  uint32_t            TxExits;
+  uint32_t            RxEntries;        /*!< Same for the receive path */
+  uint32_t            RxExits;
+  uint32_t            TxLpiMs;          /*!< Estimated time the transmit path spent in LPI */
+  uint32_t            RxLpiMs;
+  uint32_t            WakeErrors;       /*!< Wake time faults reported by the PCS */
+  uint32_t            WakeStallUs;      /*!< TxExits x DP83822_EEE_TW_SYS_TX_US, worst case delay added to transmit */
+  uint32_t            ElapsedMs;        /*!< Time covered */
+  uint32_t            Samples;          /*!< Sampling passes */
+} dp83822_LpiStats_t;
+
+/* Wake-on-LAN configuration */
+typedef struct
+{
+  uint32_t            Modes;            /*!< DP83822_WOL_xxx wake sources, 0 disables Wake-on-LAN */
+  uint8_t             Mac[6];           /*!< Station address, magic packet and unicast wake */
+  uint8_t             Password[6];      /*!< SecureOn password, with DP83822_WOL_SECURE_ON */
+  uint8_t             Pattern[DP83822_WOL_PATTERN_SIZE]; /*!< Pattern compared from PatternOffset */
+  uint64_t            PatternMask;      /*!< Bit n set: Pattern[n] must match, with DP83822_WOL_PATTERN */
+  uint32_t            PatternOffset;    /*!< Frame byte the pattern starts at, up to DP83822_RXFPATC_START */
+  uint32_t            Interrupt;        /*!< Route the wake to the INTR pin through DP83822_WOL_IT */
+} dp83822_WolCfg_t;
+
+/* Link debounce filter between the polled link and DP83822_GetLinkState() */
+typedef struct
+{
+  uint32_t            UpMs;             /*!< Link up must hold this long to be reported, 0 passes it at once */
+  uint32_t            DownMs;           /*!< Link down must hold this long to be reported */
+  uint32_t            FlapLimit;        /*!< Drops within DP83822_FLAP_WINDOW_MS that start a hold-down, 0 for none */
+  uint32_t            HoldDownMs;       /*!< Link up must hold this long during a hold-down */
+  int32_t             Stable;           /*!< Link state reported, 0 before the first poll */
+  uint32_t            Pending;          /*!< A change of link up/down is waiting for its window */
+  uint32_t            PendingTick;      /*!< Time the change was first seen */
+  uint32_t            RawUp;            /*!< Link up at the last poll */
+  uint32_t            HoldDown;         /*!< Hold-down active */
+  uint32_t            FlapTick;         /*!< Start of the current flap window */
+  uint32_t            Flaps;            /*!< Drops in the current flap window */
+  uint32_t            Drops;            /*!< Raw link drops seen */
+  uint32_t            Suppressed;       /*!< Changes that reverted within their window */
+  uint32_t            HoldDowns;        /*!< Hold-downs started */
+} dp83822_Debounce_t;
+
+/* Cable diagnostic result of one pair */
+typedef struct
+{
+  uint32_t            Fault;            /*!< DP83822_CABLE_xxx */
+  uint32_t            DistanceCm;       /*!< Distance to the fault, 0 for DP83822_CABLE_MATCH */
+  uint32_t            Amplitude;        /*!< Reflection amplitude of the fault */
+} dp83822_CablePair_t;
+
+/* Cable diagnostic result, indexed by DP83822_CABLE_PAIR_xxx */
+typedef struct
+{
+  dp83822_CablePair_t Pair[DP83822_CABLE_PAIR_NB];
+} dp83822_CableDiag_t;
+
+/* Hardware error counters, totals in the object or deltas of one sample */
+typedef struct
+{
+  uint64_t            RxErrors;         /*!< Packets received with RX_ER asserted (RECR) */
+  uint64_t            FalseCarrier;     /*!< False carrier events (FCSCR) */
+  uint32_t            Saturated;        /*!< DP83822_COUNTER_xxx found at their maximum, events may be lost */
+  uint32_t            Samples;          /*!< Sampling passes */
+  uint32_t            Frames;           /*!< MDIO frames spent sampling */
+} dp83822_Counters_t;
+
+typedef struct
+{
+  uint32_t            Tick;             /*!< GetTick value when the event was recorded */
+  uint8_t             Type;             /*!< DP83822_EVENT_xxx */
+  int8_t              LinkState;        /*!< DP83822_STATUS_xxx link state after a polled event, else 0 */
+  uint16_t            Interrupt;        /*!< DP83822_xxx_IT causes of a DP83822_EVENT_INTERRUPT,
+                                             DP83822_WOL_xxx causes of a DP83822_EVENT_WAKE, else 0 */
+} dp83822_Event_t;
+
+/* One register setting of a profile: Mask selects the bits set to Value,
+   the other bits keep their current value */
+typedef struct
+{
+  uint16_t            DevAd;            /*!< DP83822_PROFILE_BASIC, or DP83822_MMD_xxx for an extended register */
+  uint16_t            Reg;
+  uint16_t            Mask;
+  uint16_t            Value;
+} dp83822_ProfileEntry_t;
+
+typedef struct
+{
+  uint32_t            Written;          /*!< Registers that differed and were written */
+  uint32_t            Mismatches;       /*!< Registers whose masked bits differ after the apply, or on verify */
+  uint32_t            FirstMismatch;    /*!< Index of the first of them, the entry count if none */
+  uint32_t            Frames;           /*!< MDIO frames spent */
+} dp83822_ProfileResult_t;
+
+/* Fixed-size link event log, the oldest event is overwritten when full */
+typedef struct
+{
+  dp83822_Event_t     Event[DP83822_EVENT_LOG_SIZE];
+  uint32_t            Head;             /*!< Next slot to write */
+  uint32_t            Count;            /*!< Events not yet drained */
+  uint32_t            Lost;             /*!< Events overwritten since the last DP83822_ReadEvents() */
+  int32_t             LastLinkState;    /*!< Last polled link state, change detection */
+} dp83822_EventLog_t;
+
 typedef struct 
 {
   uint32_t            DevAddr;
   uint32_t            Is_Initialized;
   dp83822_IOCtx_t     IO;
   void               *pData;
+  uint32_t            AddrHint;    /*!< Address probed before scanning: strap or retained DevAddr */
+  uint32_t            ProbeCount;  /*!< PHYIDR1 probes spent on address discovery by the last init */
+  uint32_t            PreambleSuppressed; /*!< MDIO frames to this PHY are sent without preamble */
+  uint32_t            FrameCount;  /*!< MDIO frames issued through this object, wraps */
+  uint32_t            LinkMode;    /*!< DP83822_LINK_MODE_xxx, tracked from BMCR accesses */
+  uint32_t            PhystsLatch; /*!< Clear-on-read PHYSTS bits read by other calls, kept for
+                                        DP83822_GetStatus() / DP83822_GetLinkDownCause() */
+  uint32_t            InitState;   /*!< DP83822_INIT_STATE_xxx */
+  uint32_t            InitTick;    /*!< GetTick value at start of current init phase */
+  uint32_t            ITEnabled;   /*!< Enabled interrupt sources, DP83822_xxx_IT */
+  uint32_t            ITPending;   /*!< Interrupt causes drained from MISR1/2 but not yet consumed */
+  uint32_t            FastLinkDown; /*!< DP83822_FLD_xxx criteria, restored after every soft reset */
+  uint32_t            FastTimers;  /*!< DP83822_FAST_xxx options, restored after every soft reset */
+  uint32_t            FastStartState; /*!< Speed/duplex tried before autonegotiation, 0 if none */
+  uint32_t            FastStartTimeout; /*!< Forced mode deadline in ms, 0 for DP83822_FAST_START_TIMEOUT_VALUE */
+  uint32_t            Advertise;   /*!< ANAR abilities restored after every soft reset, 0 for the PHY default */
+  uint32_t            EeeMode;     /*!< DP83822_EEE_xxx advertisement restored after every soft reset */
+  uint32_t            WolConfig;   /*!< RXFCFG value written by DP83822_SetWol(), 0 when off */
+  uint32_t            LpiStatus;   /*!< PCS status 1 of the last LPI sample */
+  uint32_t            LpiTick;     /*!< GetTick value of the last LPI sample */
+  const dp83822_ProfileEntry_t *pProfile; /*!< Register profile applied after every soft reset, may be NULL */
+  uint32_t            ProfileCount; /*!< Entries of pProfile */
+  uint32_t            CableDiagRunning; /*!< TDR measurement started by DP83822_StartCableDiag() */
+  uint32_t            CableDiagTick; /*!< GetTick value at start of the TDR measurement */
+  dp83822_Shadow_t    Shadow;      /*!< Optional control register shadow */
+  dp83822_LinkPub_t   LinkPub;     /*!< Link snapshot published by DP83822_PublishStatus() */
+  dp83822_EventLog_t  Events;      /*!< Link events, drained by DP83822_ReadEvents() */
+  dp83822_Counters_t  Counters;    /*!< Error counter totals, updated by DP83822_GetCounters() */
+  dp83822_SelfTest_t  SelfTest;    /*!< BIST run started by DP83822_StartSelfTest() */
+  dp83822_Debounce_t  Debounce;    /*!< Link filter set by DP83822_SetDebounce() */
+  dp83822_LpiStats_t  Lpi;         /*!< LPI totals, updated by DP83822_GetLpiStats() */
 } dp83822_Object_t;
 
+/* Poll scheduler state of one port */
+typedef struct
+{
+  dp83822_Object_t   *pObj;
+  int32_t             LinkState;        /*!< Last polled link state, 0 before the first poll */
+  uint32_t            Interval;         /*!< Current poll period in ms */
+  uint32_t            NextTick;         /*!< Poll due time */
+  uint32_t            LastTick;         /*!< Time of the last poll */
+  uint32_t            Polls;
+  uint32_t            Changes;          /*!< Link state changes seen */
+  uint32_t            MaxGap;           /*!< Longest time between two polls in ms */
+  uint32_t            Frames;           /*!< MDIO frames spent polling */
+  uint64_t            BusNs;            /*!< MDIO bus time spent polling */
+} dp83822_SchedPort_t;
+
+/* Poll scheduler owning the PHYs of one MDIO bus */
+typedef struct
+{
+  dp83822_SchedPort_t Port[DP83822_SCHED_MAX_PORTS];
+  uint32_t            PortCount;
+  uint32_t            MinInterval;      /*!< Poll period after a change or while negotiating */
+  uint32_t            MaxInterval;      /*!< Poll period ceiling while stable */
+  uint32_t            StartTick;        /*!< Time the first port was added */
+} dp83822_Sched_t;
+
+/* Poll scheduler statistics of one port, or totals of all ports */
+typedef struct
+{
+  int32_t             LinkState;        /*!< Port: last polled link state, totals: 0 */
+  uint32_t            Interval;         /*!< Current poll period in ms, totals: the shortest */
+  uint32_t            Polls;
+  uint32_t            Changes;
+  uint32_t            MaxLatency;       /*!< Worst-case detection latency seen, the longest poll gap in ms */
+  uint32_t            Frames;
+  uint32_t            BusPpm;           /*!< Share of MDIO bus time spent polling since start, ppm */
+} dp83822_SchedStats_t;
+
 /* Exported functions --------------------------------------------------------*/
 int32_t DP83822_RegisterBusIO(dp83822_Object_t *pObj, dp83822_IOCtx_t *ioctx);
+int32_t DP83822_ScanBus(dp83822_IOCtx_t *ioctx, uint32_t *pAddr, uint32_t MaxCount, uint32_t *pCount);
 int32_t DP83822_Init(dp83822_Object_t *pObj);
+int32_t DP83822_StartInit(dp83822_Object_t *pObj);
+int32_t DP83822_PollInit(dp83822_Object_t *pObj);
+uint32_t DP83822_GetInitState(dp83822_Object_t *pObj);
+int32_t DP83822_SetShadowMode(dp83822_Object_t *pObj, uint32_t Mode);
 int32_t DP83822_DeInit(dp83822_Object_t *pObj);
 int32_t DP83822_DisablePowerDownMode(dp83822_Object_t *pObj);
 int32_t DP83822_EnablePowerDownMode(dp83822_Object_t *pObj);
 int32_t DP83822_StartAutoNego(dp83822_Object_t *pObj);
 int32_t DP83822_GetLinkState(dp83822_Object_t *pObj);
+int32_t DP83822_SetDebounce(dp83822_Object_t *pObj, uint32_t UpMs, uint32_t DownMs, uint32_t FlapLimit, uint32_t HoldDownMs);
+int32_t DP83822_GetStatus(dp83822_Object_t *pObj, dp83822_Status_t *pStatus);
+int32_t DP83822_PublishStatus(dp83822_Object_t *pObj);
+int32_t DP83822_ReadPublishedStatus(dp83822_Object_t *pObj, dp83822_Status_t *pStatus, uint32_t *pGeneration);
+uint32_t DP83822_GetPublishedGeneration(dp83822_Object_t *pObj);
 int32_t DP83822_SetLinkState(dp83822_Object_t *pObj, uint32_t LinkState);
 int32_t DP83822_EnableLoopbackMode(dp83822_Object_t *pObj);
 int32_t DP83822_DisableLoopbackMode(dp83822_Object_t *pObj);
+int32_t DP83822_SetAdvertisement(dp83822_Object_t *pObj, uint32_t Abilities);
+int32_t DP83822_GetAutoNego(dp83822_Object_t *pObj, dp83822_AutoNego_t *pResult);
+int32_t DP83822_SetEee(dp83822_Object_t *pObj, uint32_t Mode);
+int32_t DP83822_GetEee(dp83822_Object_t *pObj, dp83822_Eee_t *pResult);
+int32_t DP83822_GetLpiStats(dp83822_Object_t *pObj, dp83822_LpiStats_t *pDelta);
+int32_t DP83822_SetFastStart(dp83822_Object_t *pObj, uint32_t LinkState, uint32_t TimeoutMs);
+int32_t DP83822_SetFastTimers(dp83822_Object_t *pObj, uint32_t Options);
+int32_t DP83822_SetFastLinkDown(dp83822_Object_t *pObj, uint32_t Criteria);
+int32_t DP83822_SetProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count);
+int32_t DP83822_ApplyProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count,
+                             dp83822_ProfileResult_t *pResult);
+int32_t DP83822_VerifyProfile(dp83822_Object_t *pObj, const dp83822_ProfileEntry_t *pEntries, uint32_t Count,
+                              dp83822_ProfileResult_t *pResult);
+int32_t DP83822_GetLinkDownCause(dp83822_Object_t *pObj, uint32_t *pCause);
+int32_t DP83822_GetCounters(dp83822_Object_t *pObj, dp83822_Counters_t *pDelta);
+int32_t DP83822_StartSelfTest(dp83822_Object_t *pObj, const dp83822_SelfTestCfg_t *pCfg);
+int32_t DP83822_PollSelfTest(dp83822_Object_t *pObj, dp83822_SelfTestResult_t *pResult);
+int32_t DP83822_AbortSelfTest(dp83822_Object_t *pObj);
+int32_t DP83822_StartCableDiag(dp83822_Object_t *pObj);
+int32_t DP83822_PollCableDiag(dp83822_Object_t *pObj, dp83822_CableDiag_t *pResult);
+int32_t DP83822_GetCableLength(dp83822_Object_t *pObj, uint32_t *pLengthCm);
+int32_t DP83822_SchedInit(dp83822_Sched_t *pSched, uint32_t MinInterval, uint32_t MaxInterval);
+int32_t DP83822_SchedAddPort(dp83822_Sched_t *pSched, dp83822_Object_t *pObj);
+int32_t DP83822_SchedRun(dp83822_Sched_t *pSched, uint32_t *pChanged);
+int32_t DP83822_SchedGetStats(dp83822_Sched_t *pSched, uint32_t Port, dp83822_SchedStats_t *pStats);
+int32_t DP83822_ReadEvents(dp83822_Object_t *pObj, dp83822_Event_t *pEvents, uint32_t MaxCount, uint32_t *pCount,
+                           uint32_t *pLost);
+int32_t DP83822_ReadExtReg(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint32_t *pRegVal);
+int32_t DP83822_WriteExtReg(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint32_t RegVal);
+int32_t DP83822_ReadExtRegs(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, uint16_t *pBuf, uint32_t Count);
+int32_t DP83822_WriteExtRegs(dp83822_Object_t *pObj, uint32_t DevAd, uint32_t RegAddr, const uint16_t *pBuf, uint32_t Count);
 int32_t DP83822_EnableIT(dp83822_Object_t *pObj, uint32_t Interrupt);
 int32_t DP83822_DisableIT(dp83822_Object_t *pObj, uint32_t Interrupt);
 int32_t DP83822_ClearIT(dp83822_Object_t *pObj, uint32_t Interrupt);
 int32_t DP83822_GetITStatus(dp83822_Object_t *pObj, uint32_t Interrupt);
+int32_t DP83822_GetPendingIT(dp83822_Object_t *pObj, uint32_t *pInterrupts);
+int32_t DP83822_SetWol(dp83822_Object_t *pObj, const dp83822_WolCfg_t *pCfg);
+int32_t DP83822_GetWolStatus(dp83822_Object_t *pObj, uint32_t *pCauses);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,386 @@
+/**
+  ******************************************************************************
+  * @file    dp83822.hpp
+  * @author  Knut A. Korneliussen
+  * @brief   Header-only C++ variant of the DP83822 driver, specialized at
+  *          compile time on an IO policy so that register accesses inline
+  *          into the caller instead of going through dp83822_IOCtx_t.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. Requires C++11. Covers bring-up and the
+  * link poll hot path with the return codes and register sequences of the
+  * C driver: Init, DeInit, GetLinkState, GetStatus, SetLinkState,
+  * StartAutoNego, power down and loopback control.
+  *
+  * The IO policy is a type with static member functions:
+  *
+  *   struct BoardIO
+  *   {
+  *     static int32_t ReadReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t *pRegVal);
+  *     static int32_t WriteReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal);
+  *     static int32_t GetTick(void);
+  *   };
+  *
+  *   static dp83822::Driver<BoardIO> phy;
+  *
+  ******************************************************************************
+  */
+
+#ifndef DP83822_HPP
+#define DP83822_HPP
+
+#include <stdint.h>
+#include <dp83822.h>
+
+namespace dp83822
+{
+
+/* Typed register and bit field descriptors ---------------------------------*/
+/* A Field can only be applied to a Value read from its own register */
+template <uint16_t Addr>
+struct Field
+{
+  uint16_t Mask;
+};
+
+template <uint16_t Addr>
+struct Value
+{
+  uint32_t Raw;
+
+  constexpr bool operator[](Field<Addr> f) const { return (Raw & f.Mask) != 0; }
+  constexpr Value Set(Field<Addr> f) const { return Value{ Raw | f.Mask }; }
+  constexpr Value Clear(Field<Addr> f) const { return Value{ Raw & ~static_cast<uint32_t>(f.Mask) }; }
+};
+
+template <uint16_t A>
+struct Register
+{
+  static constexpr uint16_t Addr = A;
+  typedef Field<A> FieldType;
+  typedef Value<A> ValueType;
+};
+
+typedef Register<DP83822_BMCR>   BMCR;
+typedef Register<DP83822_BMSR>   BMSR;
+typedef Register<DP83822_PHYI1R> PHYI1R;
+typedef Register<DP83822_PHYSTS> PHYSTS;
+
+namespace bmcr
+{
+constexpr Field<BMCR::Addr> SoftReset       { DP83822_BMCR_SOFT_RESET };
+constexpr Field<BMCR::Addr> Loopback        { DP83822_BMCR_LOOPBACK };
+constexpr Field<BMCR::Addr> Speed100        { DP83822_BMCR_SPEED_SELECT };
+constexpr Field<BMCR::Addr> AutoNegoEnable  { DP83822_BMCR_AUTONEGO_EN };
+constexpr Field<BMCR::Addr> PowerDown       { DP83822_BMCR_POWER_DOWN };
+constexpr Field<BMCR::Addr> RestartAutoNego { DP83822_BMCR_RESTART_AUTONEGO };
+constexpr Field<BMCR::Addr> FullDuplex      { DP83822_BMCR_DUPLEX_MODE };
+}
+
+namespace bmsr
+{
+constexpr Field<BMSR::Addr> LinkStatus      { DP83822_BMSR_LINK_STATUS };
+}
+
+namespace physts
+{
+constexpr Field<PHYSTS::Addr> Mdix            { DP83822_PHYSTS_MDIX_MODE };
+constexpr Field<PHYSTS::Addr> RxErrorLatch    { DP83822_PHYSTS_RX_ERROR_LATCH };
+constexpr Field<PHYSTS::Addr> Polarity        { DP83822_PHYSTS_POLARITY };
+constexpr Field<PHYSTS::Addr> FalseCarrier    { DP83822_PHYSTS_FALSE_CARRIER };
+constexpr Field<PHYSTS::Addr> SignalDetect    { DP83822_PHYSTS_SIGNAL_DETECT };
+constexpr Field<PHYSTS::Addr> DescramblerLock { DP83822_PHYSTS_DESCRAMBLER_LOCK };
+constexpr Field<PHYSTS::Addr> RemoteFault     { DP83822_PHYSTS_REMOTE_FAULT };
+constexpr Field<PHYSTS::Addr> Jabber          { DP83822_PHYSTS_JABBER_DETECT };
+constexpr Field<PHYSTS::Addr> AutoNegoDone    { DP83822_PHYSTS_AUTONEGO_DONE };
+constexpr Field<PHYSTS::Addr> Speed10         { DP83822_PHYSTS_SPEED_MASK };
+constexpr Field<PHYSTS::Addr> FullDuplex      { DP83822_PHYSTS_DUPLEX_MASK };
+constexpr Field<PHYSTS::Addr> LinkStatus      { DP83822_PHYSTS_LINK_STATUS };
+}
+
+/* Link state decode ---------------------------------------------------------*/
+/* PHYSTS bits [4:0]: autonegotiation done, loopback, duplex, speed, link */
+constexpr uint32_t LinkStateIndexMask = 0x1FU;
+
+constexpr int8_t DecodePhysts(uint32_t p)
+{
+  return !(p & DP83822_PHYSTS_LINK_STATUS)    ? static_cast<int8_t>(DP83822_STATUS_LINK_DOWN) :
+         !(p & DP83822_PHYSTS_AUTONEGO_DONE)  ? static_cast<int8_t>(DP83822_STATUS_AUTONEGO_NOTDONE) :
+         (p & DP83822_PHYSTS_SPEED_MASK)
+           ? ((p & DP83822_PHYSTS_DUPLEX_MASK) ? static_cast<int8_t>(DP83822_STATUS_10MBITS_FULLDUPLEX)
+                                               : static_cast<int8_t>(DP83822_STATUS_10MBITS_HALFDUPLEX))
+           : ((p & DP83822_PHYSTS_DUPLEX_MASK) ? static_cast<int8_t>(DP83822_STATUS_100MBITS_FULLDUPLEX)
+                                               : static_cast<int8_t>(DP83822_STATUS_100MBITS_HALFDUPLEX));
+}
+
+/* Class template so the table has one definition across translation units */
+template <class Unused = void>
+struct LinkStateTable
+{
+  static constexpr int8_t Value[LinkStateIndexMask + 1U] =
+  {
+#define DP83822_HPP_ROW(i) DecodePhysts(i), DecodePhysts(i + 1U), DecodePhysts(i + 2U), DecodePhysts(i + 3U)
+    DP83822_HPP_ROW(0U),  DP83822_HPP_ROW(4U),  DP83822_HPP_ROW(8U),  DP83822_HPP_ROW(12U),
+    DP83822_HPP_ROW(16U), DP83822_HPP_ROW(20U), DP83822_HPP_ROW(24U), DP83822_HPP_ROW(28U)
+#undef DP83822_HPP_ROW
+  };
+};
+
+template <class Unused>
+constexpr int8_t LinkStateTable<Unused>::Value[LinkStateIndexMask + 1U];
+
+static_assert(LinkStateTable<>::Value[DP83822_PHYSTS_LINK_STATUS | DP83822_PHYSTS_AUTONEGO_DONE |
+                                      DP83822_PHYSTS_DUPLEX_MASK] == DP83822_STATUS_100MBITS_FULLDUPLEX,
+              "PHYSTS decode table");
+static_assert(LinkStateTable<>::Value[DP83822_PHYSTS_LINK_STATUS | DP83822_PHYSTS_AUTONEGO_DONE |
+                                      DP83822_PHYSTS_SPEED_MASK] == DP83822_STATUS_10MBITS_HALFDUPLEX,
+              "PHYSTS decode table");
+
+/* Link state of forced mode from BMCR speed/duplex */
+constexpr int32_t DecodeForced(Value<BMCR::Addr> bcr)
+{
+  return bcr[bmcr::Speed100] ? (bcr[bmcr::FullDuplex] ? DP83822_STATUS_100MBITS_FULLDUPLEX : DP83822_STATUS_100MBITS_HALFDUPLEX)
+                             : (bcr[bmcr::FullDuplex] ? DP83822_STATUS_10MBITS_FULLDUPLEX : DP83822_STATUS_10MBITS_HALFDUPLEX);
+}
+
+/* Driver --------------------------------------------------------------------*/
+template <class IO>
+class Driver
+{
+public:
+  uint32_t DevAddr        = 0;
+  uint32_t Is_Initialized = 0;
+  uint32_t AddrHint       = 0;    /*!< Address probed before scanning */
+  uint32_t LinkMode       = DP83822_LINK_MODE_UNKNOWN;
+  uint32_t PhystsLatch    = 0;    /*!< PHYSTS error latches read by GetLinkState() */
+
+  /**
+    * @brief  Initialize the DP83822, see DP83822_Init().
+    */
+  int32_t Init()
+  {
+    uint32_t addr, tick;
+    Value<BMCR::Addr> bcr{0};
+    Value<BMSR::Addr> bsr{0};
+
+    if(Is_Initialized)
+      return DP83822_STATUS_OK;
+
+    DevAddr = MaxDevAddr + 1U;
+    if(AddrHint <= MaxDevAddr && Probe(AddrHint))
+    {
+      DevAddr = AddrHint;
+    }
+    else
+    {
+      for(addr = 0; addr <= MaxDevAddr; addr++)
+      {
+        if(addr != AddrHint && Probe(addr))
+        {
+          DevAddr = addr;
+          break;
+        }
+      }
+    }
+
+    if(DevAddr > MaxDevAddr)
+      return DP83822_STATUS_ADDRESS_ERROR;
+    PhystsLatch = 0;
+
+    if(WriteCtrl(Value<BMCR::Addr>{0}.Set(bmcr::SoftReset)) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+
+    tick = static_cast<uint32_t>(IO::GetTick());
+    do
+    {
+      if(Read<BMCR>(bcr) < 0)
+        return DP83822_STATUS_READ_ERROR;
+      if(static_cast<uint32_t>(IO::GetTick()) - tick > DP83822_TIMEOUT_VALUE && bcr[bmcr::SoftReset])
+        return DP83822_STATUS_RESET_TIMEOUT;
+    } while(bcr[bmcr::SoftReset]);
+
+    if(WriteCtrl(Value<BMCR::Addr>{0}.Set(bmcr::AutoNegoEnable).Set(bmcr::RestartAutoNego)) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+
+    tick = static_cast<uint32_t>(IO::GetTick());
+    do
+    {
+      if(Read<BMCR>(bcr) < 0)
+        return DP83822_STATUS_READ_ERROR;
+      if(static_cast<uint32_t>(IO::GetTick()) - tick > DP83822_TIMEOUT_VALUE && !bcr[bmcr::AutoNegoEnable])
+        return DP83822_STATUS_RESET_TIMEOUT;
+    } while(!bcr[bmcr::AutoNegoEnable]);
+
+    Is_Initialized = 1;
+
+    /* Link comes up in the background, no cable is not an error */
+    tick = static_cast<uint32_t>(IO::GetTick());
+    do
+    {
+      if(Read<BMSR>(bsr) < 0)
+        return DP83822_STATUS_READ_ERROR;
+    } while(!bsr[bmsr::LinkStatus] && static_cast<uint32_t>(IO::GetTick()) - tick <= DP83822_LINK_TIMEOUT_VALUE);
+
+    return DP83822_STATUS_OK;
+  }
+
+  /**
+    * @brief  De-Initialize the DP83822, see DP83822_DeInit().
+    */
+  int32_t DeInit()
+  {
+    Is_Initialized = 0;
+    LinkMode = DP83822_LINK_MODE_UNKNOWN;
+    return DP83822_STATUS_OK;
+  }
+
+  /**
+    * @brief  Get link state, see DP83822_GetLinkState(). Reads BMSR, BMCR
+    *         and, when autonegotiating, PHYSTS.
+    */
+  int32_t GetLinkState()
+  {
+    Value<BMSR::Addr> bsr{0};
+    Value<BMCR::Addr> bcr{0};
+    Value<PHYSTS::Addr> sts{0};
+
+    if(Read<BMSR>(bsr) < 0)
+      return DP83822_STATUS_READ_ERROR;
+    if(!bsr[bmsr::LinkStatus])
+      return DP83822_STATUS_LINK_DOWN;
+
+    if(ReadCtrl(bcr) < 0)
+      return DP83822_STATUS_READ_ERROR;
+    if(!bcr[bmcr::AutoNegoEnable])
+      return DecodeForced(bcr);
+
+    if(Read<PHYSTS>(sts) < 0)
+      return DP83822_STATUS_READ_ERROR;
+    PhystsLatch |= sts.Raw & DP83822_PHYSTS_LATCH_MASK;
+
+    /* Link already confirmed by BMSR */
+    return LinkStateTable<>::Value[(sts.Raw | DP83822_PHYSTS_LINK_STATUS) & LinkStateIndexMask];
+  }
+
+  /**
+    * @brief  Get a consolidated link status, see DP83822_GetStatus().
+    */
+  int32_t GetStatus(dp83822_Status_t *pStatus)
+  {
+    Value<BMCR::Addr> bcr{0};
+    Value<PHYSTS::Addr> sts{0};
+    uint32_t index;
+
+    if(LinkMode == DP83822_LINK_MODE_UNKNOWN && ReadCtrl(bcr) < 0)
+      return DP83822_STATUS_READ_ERROR;
+
+    if(Read<PHYSTS>(sts) < 0)
+      return DP83822_STATUS_READ_ERROR;
+    sts.Raw |= PhystsLatch;
+    PhystsLatch = 0;
+
+    pStatus->Physts           = static_cast<uint16_t>(sts.Raw);
+    pStatus->Link             = sts[physts::LinkStatus];
+    pStatus->Speed100         = !sts[physts::Speed10];
+    pStatus->FullDuplex       = sts[physts::FullDuplex];
+    pStatus->ForcedMode       = (LinkMode == DP83822_LINK_MODE_FORCED);
+    pStatus->AutoNegoDone     = sts[physts::AutoNegoDone];
+    pStatus->Mdix             = sts[physts::Mdix];
+    pStatus->PolarityInverted = sts[physts::Polarity];
+    pStatus->RemoteFault      = sts[physts::RemoteFault];
+    pStatus->Jabber           = sts[physts::Jabber];
+    pStatus->FalseCarrier     = sts[physts::FalseCarrier];
+    pStatus->RxError          = sts[physts::RxErrorLatch];
+    pStatus->SignalDetect     = sts[physts::SignalDetect];
+    pStatus->DescramblerLock  = sts[physts::DescramblerLock];
+
+    /* Forced mode has no autonegotiation to wait for */
+    index = sts.Raw | (pStatus->ForcedMode ? DP83822_PHYSTS_AUTONEGO_DONE : 0U);
+    pStatus->LinkState = LinkStateTable<>::Value[index & LinkStateIndexMask];
+
+    return DP83822_STATUS_OK;
+  }
+
+  /**
+    * @brief  Force speed/duplex, see DP83822_SetLinkState().
+    */
+  int32_t SetLinkState(uint32_t LinkState)
+  {
+    Value<BMCR::Addr> bcr{0};
+
+    if(LinkState != DP83822_STATUS_100MBITS_FULLDUPLEX && LinkState != DP83822_STATUS_100MBITS_HALFDUPLEX &&
+       LinkState != DP83822_STATUS_10MBITS_FULLDUPLEX)
+      return DP83822_STATUS_ERROR;
+
+    if(ReadCtrl(bcr) < 0)
+      return DP83822_STATUS_READ_ERROR;
+
+    bcr = bcr.Clear(bmcr::AutoNegoEnable).Clear(bmcr::Speed100).Clear(bmcr::FullDuplex);
+    if(LinkState != DP83822_STATUS_10MBITS_FULLDUPLEX)
+      bcr = bcr.Set(bmcr::Speed100);
+    if(LinkState != DP83822_STATUS_100MBITS_HALFDUPLEX)
+      bcr = bcr.Set(bmcr::FullDuplex);
+
+    return (WriteCtrl(bcr) < 0) ? DP83822_STATUS_WRITE_ERROR : DP83822_STATUS_OK;
+  }
+
+  int32_t StartAutoNego()       { return ModifyCtrl(bmcr::AutoNegoEnable, true); }
+  int32_t EnablePowerDownMode() { return ModifyCtrl(bmcr::PowerDown, true); }
+  int32_t DisablePowerDownMode(){ return ModifyCtrl(bmcr::PowerDown, false); }
+  int32_t EnableLoopbackMode()  { return ModifyCtrl(bmcr::Loopback, true); }
+  int32_t DisableLoopbackMode() { return ModifyCtrl(bmcr::Loopback, false); }
+
+private:
+  static constexpr uint32_t MaxDevAddr = 31U;
+
+  template <class R>
+  int32_t Read(typename R::ValueType &v)
+  {
+    return IO::ReadReg(DevAddr, R::Addr, &v.Raw);
+  }
+
+  bool Probe(uint32_t Addr)
+  {
+    uint32_t reg = 0;
+    return IO::ReadReg(Addr, PHYI1R::Addr, &reg) >= 0 && reg == DP83822_PHYI1R_OUI_3_18;
+  }
+
+  /* BMCR accesses track the speed/duplex selection mode like the C driver */
+  void TrackLinkMode(Value<BMCR::Addr> bcr)
+  {
+    LinkMode = bcr[bmcr::SoftReset]      ? DP83822_LINK_MODE_UNKNOWN :
+               bcr[bmcr::AutoNegoEnable] ? DP83822_LINK_MODE_AUTONEGO : DP83822_LINK_MODE_FORCED;
+  }
+
+  int32_t ReadCtrl(Value<BMCR::Addr> &bcr)
+  {
+    int32_t status = Read<BMCR>(bcr);
+    if(status >= 0)
+      TrackLinkMode(bcr);
+    return status;
+  }
+
+  int32_t WriteCtrl(Value<BMCR::Addr> bcr)
+  {
+    int32_t status = IO::WriteReg(DevAddr, BMCR::Addr, bcr.Raw);
+    if(status >= 0)
+      TrackLinkMode(bcr);
+    return status;
+  }
+
+  int32_t ModifyCtrl(Field<BMCR::Addr> f, bool set)
+  {
+    Value<BMCR::Addr> bcr{0};
+
+    if(ReadCtrl(bcr) < 0)
+      return DP83822_STATUS_READ_ERROR;
+    if(WriteCtrl(set ? bcr.Set(f) : bcr.Clear(f)) < 0)
+      return DP83822_STATUS_WRITE_ERROR;
+    return DP83822_STATUS_OK;
+  }
+};
+
+} /* namespace dp83822 */
+
+#endif /* DP83822_HPP */
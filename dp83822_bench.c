@@ -0,0 +1,449 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_bench.c
+  * @author  Knut A. Korneliussen
+  * @brief   Host benchmark and regression check of the DP83822 PHY driver on
+  *          the simulated MDIO bus. Prints the MDIO cost of every API call and
+  *          the timing figures of the simulator measurements, and fails when
+  *          a call costs more frames than its recorded baseline or a figure
+  *          leaves its bounds.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. Built by CMakeLists.txt and run by ctest,
+  * any hosted C99 toolchain.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <dp83822_sim.h>
+
+/* Private types -------------------------------------------------------------*/
+/* MDIO frames of one DP83822_SIM_Benchmark() entry, in call order, with the
+   plain IO context and with batch + shadow. Lower the numbers when a change
+   saves frames. */
+typedef struct
+{
+  const char  *Name;
+  uint32_t     Frames;
+  uint32_t     FramesBatchShadow;
+} dp83822_BenchBaseline_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const dp83822_BenchBaseline_t DP83822_Baseline[] =
+{
+  { "DP83822_ScanBus(&io, &addr, 1, &found)",                                                    33,     33 },
+  { "DP83822_Init(&obj)",                                                                    117269, 117269 },
+  { "DP83822_GetLinkState(&obj)",                                                                 3,      2 },
+  { "DP83822_GetStatus(&obj, &status)",                                                           1,      1 },
+  { "DP83822_PublishStatus(&obj)",                                                                1,      1 },
+  { "DP83822_ReadPublishedStatus(&obj, &status, &generation)",                                    0,      0 },
+  { "DP83822_ReadEvents(&obj, events, 4, &found, 0)",                                             0,      0 },
+  { "DP83822_GetCounters(&obj, &counters)",                                                       2,      2 },
+  { "DP83822_GetCableLength(&obj, &regval)",                                                      5,      5 },
+  { "DP83822_SetFastLinkDown(&obj, DP83822_FLD_ENERGY_LOST | DP83822_FLD_DESCRAMBLER_LOSS)",      2,      2 },
+  { "DP83822_GetLinkDownCause(&obj, &cause)",                                                     1,      1 },
+  { "DP83822_SetLinkState(&obj, DP83822_STATUS_100MBITS_FULLDUPLEX)",                             2,      1 },
+  { "DP83822_StartAutoNego(&obj)",                                                                2,      1 },
+  { "DP83822_GetAutoNego(&obj, &autonego)",                                                       4,      4 },
+  { "DP83822_SetEee(&obj, DP83822_EEE_ENABLED)",                                                 10,      9 },
+  { "DP83822_GetEee(&obj, &eee)",                                                                10,     10 },
+  { "DP83822_GetLpiStats(&obj, &lpi)",                                                            8,      8 },
+  { "DP83822_EnablePowerDownMode(&obj)",                                                          2,      1 },
+  { "DP83822_DisablePowerDownMode(&obj)",                                                         2,      1 },
+  { "DP83822_EnableLoopbackMode(&obj)",                                                           2,      1 },
+  { "DP83822_DisableLoopbackMode(&obj)",                                                          2,      1 },
+  { "DP83822_StartSelfTest(&obj, &selftest)",                                                     6,      5 },
+  { "DP83822_PollSelfTest(&obj, &result)",                                                        2,      2 },
+  { "DP83822_AbortSelfTest(&obj)",                                                                2,      2 },
+  { "DP83822_StartCableDiag(&obj)",                                                               1,      1 },
+  { "DP83822_PollCableDiag(&obj, &cablediag)",                                                    1,      1 },
+  { "DP83822_PollCableDiag(&obj, &cablediag)",                                                   15,     15 },
+  { "DP83822_EnableIT(&obj, DP83822_LINK_STATUS_CHANGE_IT | DP83822_AUTONEGO_COMPLETE_IT)",       3,      3 },
+  { "DP83822_GetITStatus(&obj, DP83822_LINK_STATUS_CHANGE_IT)",                                   1,      1 },
+  { "DP83822_GetPendingIT(&obj, &pending)",                                                       1,      1 },
+  { "DP83822_ClearIT(&obj, DP83822_ALL_IT)",                                                      2,      2 },
+  { "DP83822_DisableIT(&obj, DP83822_ALL_IT)",                                                    4,      3 },
+  { "DP83822_ReadExtReg(&obj, DP83822_MMD_VENDOR, 0x0000U, &regval)",                             4,      4 },
+  { "DP83822_ReadExtRegs(&obj, DP83822_MMD_VENDOR, 0x0000U, extregs, 16)",                       19,     19 },
+  { "DP83822_ApplyProfile(&obj, board, 4, &profile)",                                            13,     13 },
+  { "DP83822_ApplyProfile(&obj, board, 4, &profile)",                                             7,      7 },
+  { "DP83822_VerifyProfile(&obj, board, 4, &profile)",                                            7,      7 },
+  { "DP83822_SetWol(&obj, &wol)",                                                                16,     15 },
+  { "DP83822_GetWolStatus(&obj, &cause)",                                                         4,      4 },
+  { "DP83822_SchedRun(&sched, &pending)",                                                         1,      2 },
+  { "DP83822_DeInit(&obj)",                                                                       0,      0 },
+};
+
+#define DP83822_BASELINE_NB  (sizeof(DP83822_Baseline) / sizeof(DP83822_Baseline[0]))
+
+static uint32_t Failures;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Check(uint32_t Ok, const char *What);
+static void BenchCost(uint32_t Flags);
+static void BenchLinkUp(void);
+static void BenchLinkDown(void);
+static void BenchFastLinkDownInit(void);
+static void BenchProfileReject(void);
+static void BenchEventOverflow(void);
+static void BenchSelfTestError(void);
+static void BenchDebounce(void);
+static void BenchSched(void);
+static void BenchLpi(void);
+
+/* Functions -----------------------------------------------------------------*/
+int main(void)
+{
+  BenchCost(0);
+  BenchCost(DP83822_SIM_BENCH_BATCH | DP83822_SIM_BENCH_SHADOW);
+  BenchLinkUp();
+  BenchLinkDown();
+  BenchFastLinkDownInit();
+  BenchProfileReject();
+  BenchEventOverflow();
+  BenchSelfTestError();
+  BenchDebounce();
+  BenchSched();
+  BenchLpi();
+
+  printf("\n%s: %u failure(s)\n", Failures ? "FAILED" : "PASSED", Failures);
+  return Failures ? 1 : 0;
+}
+
+/**
+  * @brief  Count a failed check.
+  */
+static void Check(uint32_t Ok, const char *What)
+{
+  if(!Ok)
+  {
+    printf("  FAIL: %s\n", What);
+    Failures++;
+  }
+}
+
+/**
+  * @brief  MDIO cost of every API call, compared against DP83822_Baseline.
+  */
+static void BenchCost(uint32_t Flags)
+{
+  dp83822_SimBench_t result[DP83822_SIM_BENCH_MAX];
+  uint32_t n = DP83822_SIM_Benchmark(Flags, result, DP83822_SIM_BENCH_MAX), i, frames, limit;
+
+  printf("\nMDIO cost per call%s\n", Flags ? ", batch + shadow" : "");
+  Check(n == DP83822_BASELINE_NB, "every call has a baseline");
+  printf("  %-88s %6s %6s %6s %8s\n", "Call", "Reads", "Writes", "Jobs", "Bus us");
+
+  for(i = 0; i < n; i++)
+  {
+    frames = result[i].Cost.Reads + result[i].Cost.Writes;
+    printf("  %-88s %6u %6u %6u %8u\n", result[i].Name, result[i].Cost.Reads, result[i].Cost.Writes,
+           result[i].Cost.Jobs, result[i].Cost.BusUs);
+
+    if(i >= DP83822_BASELINE_NB || strcmp(DP83822_Baseline[i].Name, result[i].Name) != 0)
+    {
+      Check(0, "call order matches the baseline table");
+      continue;
+    }
+
+    limit = Flags ? DP83822_Baseline[i].FramesBatchShadow : DP83822_Baseline[i].Frames;
+    if(frames > limit)
+      printf("  %s: %u frames, baseline %u\n", result[i].Name, frames, limit);
+    Check(frames <= limit, "MDIO frames within baseline");
+  }
+}
+
+/**
+  * @brief  Boot to link up with autonegotiation, fast timers and fast start.
+  */
+static void BenchLinkUp(void)
+{
+  uint32_t an = 0, fast = 0, forced = 0;
+
+  printf("\nBoot to link up\n");
+  Check(DP83822_SIM_MeasureLinkUp(DP83822_SIM_PARTNER_ABILITY, 0, 0, &an) == DP83822_STATUS_OK,
+        "link up with autonegotiation");
+  Check(DP83822_SIM_MeasureLinkUp(DP83822_SIM_PARTNER_ABILITY, 0, DP83822_FAST_AUTONEGO, &fast) == DP83822_STATUS_OK,
+        "link up with fast autonegotiation");
+  Check(DP83822_SIM_MeasureLinkUp(DP83822_SIM_PARTNER_ABILITY, DP83822_STATUS_100MBITS_FULLDUPLEX, 0, &forced) ==
+        DP83822_STATUS_OK, "link up with fast start");
+  printf("  autonegotiation %u ms, fast timers %u ms, fast start %u ms\n", an, fast, forced);
+
+  Check(an <= 1600U, "autonegotiation link up within 1.6 s");
+  Check(fast <= 600U, "fast autonegotiation link up within 0.6 s");
+  Check(forced <= 150U, "fast start link up within 0.15 s");
+}
+
+/**
+  * @brief  Cable unplug to link drop and to polled notification.
+  */
+static void BenchLinkDown(void)
+{
+  uint32_t detect = 0, notify = 0, fdetect = 0, fnotify = 0;
+
+  printf("\nCable unplug to link down, 10 ms poll\n");
+  Check(DP83822_SIM_MeasureLinkDown(0, 10, &detect, &notify) == DP83822_STATUS_OK, "standard link down");
+  Check(DP83822_SIM_MeasureLinkDown(DP83822_FLD_ENERGY_LOST, 10, &fdetect, &fnotify) == DP83822_STATUS_OK,
+        "fast link down");
+  printf("  standard %u us / %u us, energy lost %u us / %u us\n", detect, notify, fdetect, fnotify);
+
+  Check(fdetect <= 100U, "fast link down detects within 100 us");
+  Check(fnotify <= 10100U, "fast link down reported by the next poll");
+  Check(detect >= 200000U, "standard link down keeps the link fail timer");
+}
+
+/**
+  * @brief  Raw and reported link changes of a flap storm.
+  */
+static void BenchDebounce(void)
+{
+  uint32_t raw = 0, reported = 0, fraw = 0, freported = 0;
+
+  printf("\nFlap storm, 6 cable pulls 3 s apart\n");
+  Check(DP83822_SIM_MeasureDebounce(0, 0, 0, 0, 6, 3000, &raw, &reported) == DP83822_STATUS_OK, "unfiltered storm");
+  Check(DP83822_SIM_MeasureDebounce(500, 2000, 3, 5000, 6, 3000, &fraw, &freported) == DP83822_STATUS_OK,
+        "filtered storm");
+  printf("  unfiltered %u raw / %u reported, filtered %u raw / %u reported\n", raw, reported, fraw, freported);
+
+  Check(raw == 12U && reported == 12U, "unfiltered storm reports every change");
+  Check(freported == 2U, "filtered storm reports one down and one up");
+}
+
+/**
+  * @brief  Bus share of adaptive against fixed rate polling of 8 PHYs.
+  */
+static void BenchSched(void)
+{
+  dp83822_SchedStats_t adaptive, fixed;
+
+  printf("\nPoll scheduler, 8 PHYs, 20 s\n");
+  Check(DP83822_SIM_MeasureSched(8, 10, 1000, 20000, &adaptive) == DP83822_STATUS_OK, "adaptive poll");
+  Check(DP83822_SIM_MeasureSched(8, 10, 10, 20000, &fixed) == DP83822_STATUS_OK, "fixed poll");
+  printf("  adaptive 10/1000 ms: %u ppm, %u ms latency; fixed 10 ms: %u ppm, %u ms latency\n",
+         adaptive.BusPpm, adaptive.MaxLatency, fixed.BusPpm, fixed.MaxLatency);
+
+  Check(adaptive.BusPpm * 50U <= fixed.BusPpm, "adaptive poll below 2 % of the fixed poll bus time");
+  /* One poll slot per millisecond, staggered ports may slip a slot or two */
+  Check(adaptive.MaxLatency <= 1000U + 8U, "adaptive poll latency bounded by MaxInterval");
+}
+
+/**
+  * @brief  Fast link down criteria set before DP83822_Init() survive its soft
+  *         reset and a later reinit.
+  */
+static void BenchFastLinkDownInit(void)
+{
+  static dp83822_Object_t obj;
+  dp83822_IOCtx_t io;
+  uint32_t cause = 0, t;
+
+  printf("\nFast link down across init\n");
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_SetCable(1, 1);
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+
+  Check(DP83822_SetFastLinkDown(&obj, DP83822_FLD_ENERGY_LOST) == DP83822_STATUS_OK, "criteria before init");
+  Check(DP83822_Init(&obj) == DP83822_STATUS_OK, "init with fast link down");
+  Check((DP83822_Sim.Phy[1].Reg[DP83822_CR3] & DP83822_CR3_FLD_MASK) == DP83822_FLD_ENERGY_LOST,
+        "CR3 written by init");
+
+  DP83822_DeInit(&obj);
+  Check(DP83822_Init(&obj) == DP83822_STATUS_OK, "reinit");
+  Check((DP83822_Sim.Phy[1].Reg[DP83822_CR3] & DP83822_CR3_FLD_MASK) == DP83822_FLD_ENERGY_LOST,
+        "CR3 restored by reinit");
+
+  for(t = 0; t < 5000U && DP83822_GetLinkState(&obj) == DP83822_STATUS_LINK_DOWN; t++)
+    DP83822_SIM_Advance(1);
+  DP83822_SIM_SetCable(1, 0);
+  DP83822_SIM_Advance(1);
+  Check(DP83822_GetLinkState(&obj) == DP83822_STATUS_LINK_DOWN, "fast link drop after reinit");
+  Check(DP83822_GetLinkDownCause(&obj, &cause) == DP83822_STATUS_OK && cause == DP83822_FLD_ENERGY_LOST,
+        "energy lost cause");
+  printf("  CR3 0x%04X, cause 0x%X\n", DP83822_Sim.Phy[1].Reg[DP83822_CR3], cause);
+
+  /* MLT3 errors are only reported with a receive error to show for them */
+  Check(DP83822_SetFastLinkDown(&obj, DP83822_FLD_MLT3_ERRORS) == DP83822_STATUS_OK, "MLT3 criterion");
+  DP83822_SIM_SetCable(1, 1);
+  DP83822_SIM_Advance(5000);
+  DP83822_GetLinkState(&obj);
+  DP83822_SIM_SetCable(1, 0);
+  DP83822_SIM_Advance(1000);
+  Check(DP83822_GetLinkState(&obj) == DP83822_STATUS_LINK_DOWN, "link drop with MLT3 criterion");
+  Check(DP83822_GetLinkDownCause(&obj, &cause) == DP83822_STATUS_OK && cause == 0, "unexplained cause left unknown");
+  DP83822_SIM_AddErrors(1, 1, 0);
+  Check(DP83822_GetLinkDownCause(&obj, &cause) == DP83822_STATUS_OK && cause == DP83822_FLD_MLT3_ERRORS,
+        "MLT3 cause from a receive error");
+}
+
+/**
+  * @brief  Entries for the same register are applied in table order, and
+  *         profiles naming a clear-on-read or driver-owned register are
+  *         rejected without a bus access with the result still filled.
+  */
+static void BenchProfileReject(void)
+{
+  static dp83822_Object_t obj;
+  static const dp83822_ProfileEntry_t misr[] =
+  {
+    DP83822_PROFILE_REG(DP83822_LEDCR, DP83822_LEDCR_BLINK_RATE, 0x0200U),
+    DP83822_PROFILE_REG(DP83822_MISR1, 0x0000U, 0x0000U)
+  };
+  static const dp83822_ProfileEntry_t leds[] =
+  {
+    DP83822_PROFILE_REG(DP83822_LEDCR, DP83822_LEDCR_BLINK_RATE, 0x0200U),
+    DP83822_PROFILE_REG(DP83822_PHYCR, DP83822_PHYCR_MDIX_EN, DP83822_PHYCR_MDIX_EN),
+    DP83822_PROFILE_REG(DP83822_LEDCR, 0x0080U, 0x0080U)                 /* LED_0 polarity */
+  };
+  static const dp83822_ProfileEntry_t cr3[] =
+  {
+    DP83822_PROFILE_REG(DP83822_CR3, DP83822_CR3_FLD_MASK, DP83822_FLD_ENERGY_LOST)
+  };
+  static const dp83822_ProfileEntry_t owned[] =
+  {
+    DP83822_PROFILE_EXT(DP83822_MMD_AUTONEGO, DP83822_EEE_ADVERTISE, DP83822_EEE_100BASE_TX, 0x0000U),
+    DP83822_PROFILE_EXT(DP83822_MMD_VENDOR, DP83822_RXFCFG, DP83822_RXFCFG_WOL_EN, DP83822_RXFCFG_WOL_EN)
+  };
+  dp83822_IOCtx_t io;
+  dp83822_ProfileResult_t result;
+  uint32_t frames;
+
+  printf("\nProfile register checks\n");
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+  Check(DP83822_Init(&obj) == DP83822_STATUS_OK, "init");
+
+  Check(DP83822_ApplyProfile(&obj, leds, 3, &result) == DP83822_STATUS_OK, "two LEDCR fields applied");
+  Check(result.Written == 1 && result.Mismatches == 0, "LEDCR fields merged into one write");
+  Check((DP83822_Sim.Phy[1].Reg[DP83822_LEDCR] & 0x0680U) == 0x0280U, "both LEDCR fields held");
+  Check(DP83822_VerifyProfile(&obj, leds, 3, &result) == DP83822_STATUS_OK, "two LEDCR fields verified");
+
+  Check(DP83822_SetProfile(&obj, misr, 2) == DP83822_STATUS_ERROR, "MISR1 profile rejected");
+  Check(DP83822_SetProfile(&obj, cr3, 1) == DP83822_STATUS_ERROR, "CR3 profile rejected");
+  Check(DP83822_SetProfile(&obj, &owned[0], 1) == DP83822_STATUS_ERROR, "EEE advertisement profile rejected");
+  Check(DP83822_SetProfile(&obj, &owned[1], 1) == DP83822_STATUS_ERROR, "Wake-on-LAN filter profile rejected");
+
+  memset(&result, 0xA5, sizeof(result));
+  frames = obj.FrameCount;
+  Check(DP83822_VerifyProfile(&obj, misr, 2, &result) == DP83822_STATUS_ERROR, "MISR1 verify rejected");
+  Check(obj.FrameCount == frames, "no MDIO frame for a rejected profile");
+  Check(result.Written == 0 && result.Mismatches == 0 && result.FirstMismatch == 2 && result.Frames == 0,
+        "result filled on rejection");
+}
+
+/**
+  * @brief  An overflowed event log still drains with DP83822_STATUS_OK and
+  *         reports the overwritten events once.
+  */
+static void BenchEventOverflow(void)
+{
+  static dp83822_Object_t obj;
+  dp83822_Event_t events[DP83822_EVENT_LOG_SIZE];
+  dp83822_IOCtx_t io;
+  uint32_t n = 0, lost = 0, t;
+
+  printf("\nEvent log overflow\n");
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_SetCable(1, 1);
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+  Check(DP83822_Init(&obj) == DP83822_STATUS_OK, "init");
+
+  /* Every pull and reconnect logs a link down and a link up */
+  for(t = 0; t < DP83822_EVENT_LOG_SIZE; t++)
+  {
+    DP83822_SIM_Advance(3000);
+    DP83822_GetLinkState(&obj);
+    DP83822_SIM_SetCable(1, 0);
+    DP83822_SIM_Advance(1000);
+    DP83822_GetLinkState(&obj);
+    DP83822_SIM_SetCable(1, 1);
+  }
+
+  Check(DP83822_ReadEvents(&obj, events, DP83822_EVENT_LOG_SIZE, &n, &lost) == DP83822_STATUS_OK,
+        "overflowed log drains");
+  printf("  %u events drained, %u lost\n", n, lost);
+  Check(n == DP83822_EVENT_LOG_SIZE && lost != 0, "full log and lost count");
+  Check(DP83822_ReadEvents(&obj, events, DP83822_EVENT_LOG_SIZE, &n, &lost) == DP83822_STATUS_OK &&
+        n == 0 && lost == 0, "lost count reported once");
+}
+
+/**
+  * @brief  A near-end self-test that fails to start leaves BMCR as it was.
+  */
+static void BenchSelfTestError(void)
+{
+  static dp83822_Object_t obj;
+  dp83822_SelfTestCfg_t cfg = { DP83822_BIST_LOOPBACK_PCS_OUTPUT, 0, 0, 10, 0 };
+  dp83822_IOCtx_t io;
+  uint16_t bmcr;
+
+  printf("\nSelf-test start error\n");
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_SetCable(1, 1);
+  DP83822_SIM_GetIOCtx(&io, 0);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+  DP83822_SetShadowMode(&obj, DP83822_SHADOW_ENABLED);
+  Check(DP83822_Init(&obj) == DP83822_STATUS_OK, "init");
+  bmcr = DP83822_Sim.Phy[1].Reg[DP83822_BMCR];
+
+  /* BMCR comes from the shadow, the first read is the BICSR1 drain */
+  DP83822_SIM_InjectReadErrors(1);
+  Check(DP83822_StartSelfTest(&obj, &cfg) == DP83822_STATUS_READ_ERROR, "start fails on BICSR1 read");
+  Check(DP83822_Sim.Phy[1].Reg[DP83822_BMCR] == bmcr, "BMCR restored");
+  Check(DP83822_Sim.Phy[1].Reg[DP83822_BISCR] == 0, "generator off");
+  Check(DP83822_StartSelfTest(&obj, &cfg) == DP83822_STATUS_OK && DP83822_AbortSelfTest(&obj) == DP83822_STATUS_OK,
+        "later start");
+  Check(DP83822_Sim.Phy[1].Reg[DP83822_BMCR] == bmcr, "BMCR restored after abort");
+}
+
+/**
+  * @brief  LPI residency of a 2 ms busy / 8 ms idle pattern sampled every ms.
+  */
+static void BenchLpi(void)
+{
+  static dp83822_Object_t obj;
+  dp83822_IOCtx_t io;
+  dp83822_Eee_t eee;
+  dp83822_LpiStats_t delta;
+  uint32_t t, pct;
+
+  printf("\nEEE, 2 ms busy / 8 ms idle, 1 ms sampling\n");
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1)->PartnerEee = DP83822_EEE_100BASE_TX;
+  DP83822_SIM_SetCable(1, 1);
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+  DP83822_SetEee(&obj, DP83822_EEE_ENABLED);
+
+  Check(DP83822_Init(&obj) == DP83822_STATUS_OK, "init with EEE");
+  Check(DP83822_GetEee(&obj, &eee) == DP83822_STATUS_OK && eee.Active, "EEE active");
+
+  DP83822_GetLpiStats(&obj, &delta);
+  for(t = 0; t < 1000U; t++)
+  {
+    DP83822_SIM_Advance(1);
+    DP83822_GetLpiStats(&obj, &delta);
+  }
+
+  pct = obj.Lpi.ElapsedMs ? (100U * obj.Lpi.TxLpiMs) / obj.Lpi.ElapsedMs : 0U;
+  printf("  %u LPI entries, %u of %u ms in LPI (%u %%)\n", obj.Lpi.TxEntries, obj.Lpi.TxLpiMs,
+         obj.Lpi.ElapsedMs, pct);
+
+  Check(obj.Lpi.TxEntries >= 95U, "every LPI period counted");
+  Check(pct >= 65U && pct <= 80U, "LPI residency of the idle pattern");
+}
@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_bench_cpp.cpp
+  * @author  Knut A. Korneliussen
+  * @brief   Side-by-side run of the C and C++ DP83822 drivers on the simulated
+  *          MDIO bus. Prints MDIO cost and host time per call and fails when
+  *          the two drivers differ in return value or MDIO frames.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. Built by CMakeLists.txt and run by ctest,
+  * any hosted C++11 toolchain.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <dp83822_sim.hpp>
+
+/* Private define ------------------------------------------------------------*/
+#define DP83822_BENCH_CPP_ITERATIONS  100000U
+
+/* Functions -----------------------------------------------------------------*/
+int main(void)
+{
+  dp83822_SimCompare_t result[DP83822_SIM_COMPARE_MAX];
+  uint32_t n = DP83822_SIM_CompareCpp(DP83822_BENCH_CPP_ITERATIONS, result, DP83822_SIM_COMPARE_MAX), i;
+  uint32_t failures = 0;
+
+  printf("%-22s %8s %8s %8s %8s %8s %8s\n", "Call", "C st", "C++ st", "Reads", "Writes", "C ns", "C++ ns");
+
+  for(i = 0; i < n; i++)
+  {
+    const dp83822_SimCompare_t *r = &result[i];
+
+    printf("%-22s %8d %8d %8u %8u %8u %8u\n", r->Name, (int)r->StatusC, (int)r->StatusCpp,
+           r->CostC.Reads, r->CostC.Writes, r->NsC, r->NsCpp);
+
+    if(r->StatusC != r->StatusCpp || r->CostC.Reads != r->CostCpp.Reads || r->CostC.Writes != r->CostCpp.Writes)
+    {
+      printf("  FAIL: %s differs between the C and C++ drivers\n", r->Name);
+      failures++;
+    }
+  }
+
+  if(n != DP83822_SIM_COMPARE_MAX)
+  {
+    printf("  FAIL: %u of %u calls compared\n", n, DP83822_SIM_COMPARE_MAX);
+    failures++;
+  }
+
+  printf("\n%s: %u failure(s)\n", failures ? "FAILED" : "PASSED", failures);
+  return failures ? 1 : 0;
+}
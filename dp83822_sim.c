@@ -0,0 +1,1292 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_sim.c
+  * @author  Knut A. Korneliussen
+  * @brief   Host-side simulated DP83822 MDIO bus for the DP83822 PHY driver.
+  *          Models soft reset timing, autonegotiation progression, forced
+  *          mode, cable plug/unplug (link flaps), clear-on-read interrupt
+  *          status and injected read errors, and accounts every MDIO frame
+  *          as simulated bus time.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. The model plugs into the driver through
+  * dp83822_IOCtx_t and builds on any hosted C99 toolchain, no HAL required.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <dp83822_sim.h>
+
+/* Private define ------------------------------------------------------------*/
+#define DP83822_SIM_NS_PER_MS            ((uint64_t)1000000U)
+
+#define DP83822_SIM_BMCR_DEFAULT         0x3100U  /* 100 Mbit/s, autonegotiation, full duplex */
+#define DP83822_SIM_BMSR_DEFAULT         0x7849U  /* 10/100 HD/FD, preamble suppression, AN able */
+#define DP83822_SIM_BMSR_AUTONEGO_CPLT   0x0020U
+#define DP83822_SIM_ANAR_DEFAULT         0x01E1U
+#define DP83822_SIM_PHYSCR_DEFAULT       0x0108U
+#define DP83822_SIM_RCSR_DEFAULT         0x0061U  /* RMII mode, 50 MHz reference clock */
+#define DP83822_SIM_PHYCR_DEFAULT        0x8000U  /* Auto MDI/MDI-X, strap address in bits [4:0] */
+
+
+#define DP83822_SIM_MISR1_ENERGY         0x4000U
+#define DP83822_SIM_MISR1_LINK           0x2000U
+#define DP83822_SIM_MISR1_SPEED          0x1000U
+#define DP83822_SIM_MISR1_DUPLEX         0x0800U
+#define DP83822_SIM_MISR1_AUTONEGO       0x0400U
+#define DP83822_SIM_MISR2_WOL            0x0200U
+
+#define DP83822_SIM_NO_LINK              0xFFFFFFFFU
+
+/* Exported variables --------------------------------------------------------*/
+dp83822_Sim_t DP83822_Sim;
+
+/* Private function prototypes -----------------------------------------------*/
+static void DP83822_SIM_Frame(uint32_t DevAddr);
+static void DP83822_SIM_Update(void);
+static void DP83822_SIM_ResetPhy(dp83822_SimPhy_t *phy);
+static void DP83822_SIM_LinkDown(dp83822_SimPhy_t *phy);
+static void DP83822_SIM_ScheduleLink(dp83822_SimPhy_t *phy);
+static uint32_t DP83822_SIM_Resolve(dp83822_SimPhy_t *phy);
+static uint32_t DP83822_SIM_ExtAccess(dp83822_SimPhy_t *phy, uint32_t Write, uint32_t RegVal);
+static uint32_t DP83822_SIM_BistLocked(dp83822_SimPhy_t *phy);
+static void DP83822_SIM_TdrResult(dp83822_SimPhy_t *phy);
+static uint32_t DP83822_SIM_LpiStatus(dp83822_SimPhy_t *phy);
+static uint32_t DP83822_SIM_WolMatch(dp83822_SimPhy_t *phy, const uint8_t *pFrame, uint32_t Len);
+
+/**
+  * @brief  Reset the simulated bus: no PHY present, time zero, default MDC.
+  */
+void DP83822_SIM_Init(void)
+{
+  memset(&DP83822_Sim, 0, sizeof(DP83822_Sim));
+  DP83822_Sim.MdcHz       = DP83822_SIM_MDC_HZ_DEFAULT;
+  DP83822_Sim.FrameClocks = DP83822_SIM_FRAME_CLOCKS;
+}
+
+/**
+  * @brief  Attach a DP83822 to the simulated bus, cable unplugged.
+  * @param  Addr: PHY address 0..31
+  * @retval Model of the PHY for further configuration, NULL if Addr invalid
+  */
+dp83822_SimPhy_t *DP83822_SIM_AddPhy(uint32_t Addr)
+{
+  dp83822_SimPhy_t *phy;
+
+  if(Addr > 31U)
+  {
+    return NULL;
+  }
+
+  phy = &DP83822_Sim.Phy[Addr];
+  memset(phy, 0, sizeof(*phy));
+  phy->Present          = 1;
+  phy->ResetTimeMs      = DP83822_SIM_RESET_TIME_MS;
+  phy->AutoNegoTimeMs   = DP83822_SIM_AUTONEGO_TIME_MS;
+  phy->FastAutoNegoTimeMs = DP83822_SIM_FAST_AUTONEGO_TIME_MS;
+  phy->ForcedLinkTimeMs = DP83822_SIM_FORCED_LINK_TIME_MS;
+  phy->LinkLossTimeMs   = DP83822_SIM_LINK_LOSS_TIME_MS;
+  phy->PartnerAbility   = DP83822_SIM_PARTNER_ABILITY;
+  phy->TdrTimeMs        = DP83822_SIM_TDR_TIME_MS;
+  phy->CableLengthCm    = DP83822_SIM_CABLE_LENGTH_CM;
+  phy->PartnerEee       = DP83822_EEE_100BASE_TX;
+  phy->LpiBusyMs        = DP83822_SIM_LPI_BUSY_MS;
+  phy->LpiIdleMs        = DP83822_SIM_LPI_IDLE_MS;
+  DP83822_SIM_ResetPhy(phy);
+
+  return phy;
+}
+
+/**
+  * @brief  Plug or unplug the cable of a simulated PHY. Toggling this models
+  *         a link flap, including the energy detect and link change causes.
+  */
+void DP83822_SIM_SetCable(uint32_t Addr, uint32_t Connected)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[Addr & 31U];
+
+  if(!phy->Present || (phy->CableConnected != 0) == (Connected != 0))
+  {
+    return;
+  }
+
+  phy->CableConnected = (Connected != 0);
+  phy->Reg[DP83822_MISR1] |= DP83822_SIM_MISR1_ENERGY;
+
+  if(Connected)
+  {
+    if(phy->LinkDownAtNs)
+    {
+      /* Glitch shorter than the link fail detection */
+      phy->LinkDownAtNs = 0;
+      return;
+    }
+    DP83822_SIM_ScheduleLink(phy);
+  }
+  else if(phy->LinkUp)
+  {
+    /* Energy and descrambler sync are lost at once, the other criteria never fire on an unplug */
+    if(phy->Reg[DP83822_CR3] & (DP83822_FLD_ENERGY_LOST | DP83822_FLD_DESCRAMBLER_LOSS))
+      phy->LinkDownAtNs = DP83822_Sim.NowNs + (uint64_t)DP83822_SIM_FAST_LINK_DOWN_US * 1000U;
+    else
+      phy->LinkDownAtNs = DP83822_Sim.NowNs + (uint64_t)phy->LinkLossTimeMs * DP83822_SIM_NS_PER_MS;
+  }
+  else
+  {
+    DP83822_SIM_LinkDown(phy);
+  }
+}
+
+/**
+  * @brief  Advance simulated time without any MDIO traffic.
+  */
+void DP83822_SIM_Advance(uint32_t Ms)
+{
+  DP83822_Sim.NowNs += (uint64_t)Ms * DP83822_SIM_NS_PER_MS;
+  DP83822_SIM_Update();
+}
+
+/**
+  * @brief  Make the next Count MDIO reads fail.
+  */
+void DP83822_SIM_InjectReadErrors(uint32_t Count)
+{
+  DP83822_Sim.ReadErrors = Count;
+}
+
+/**
+  * @brief  Level of the INTn output of a simulated PHY.
+  * @retval 1 if an enabled cause is pending and the interrupt output is on
+  */
+uint32_t DP83822_SIM_IsITAsserted(uint32_t Addr)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[Addr & 31U];
+  uint32_t misr1 = phy->Reg[DP83822_MISR1], misr2 = phy->Reg[DP83822_MISR2];
+
+  if(!phy->Present || !(phy->Reg[DP83822_PHYSCR] & DP83822_PHYSCR_INTEN))
+  {
+    return 0;
+  }
+
+  return ((((misr1 >> 8) & misr1) | ((misr2 >> 8) & misr2)) & DP83822_MISR_INT_EN_MASK) != 0;
+}
+
+/**
+  * @brief  Count receive errors and false carrier events and set their
+  *         PHYSTS latches. The RECR and FCSCR counters saturate like the
+  *         hardware.
+  */
+void DP83822_SIM_AddErrors(uint32_t Addr, uint32_t RxErrors, uint32_t FalseCarrier)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[Addr & 31U];
+  uint32_t recr  = phy->Reg[DP83822_RECR] + RxErrors;
+  uint32_t fcscr = phy->Reg[DP83822_FCSCR] + FalseCarrier;
+
+  if(RxErrors)
+    phy->PhystsLatch |= DP83822_PHYSTS_RX_ERROR_LATCH;
+  if(FalseCarrier)
+    phy->PhystsLatch |= DP83822_PHYSTS_FALSE_CARRIER;
+
+  phy->Reg[DP83822_RECR]  = (uint16_t)((recr > DP83822_RECR_RXERCNT) ? DP83822_RECR_RXERCNT : recr);
+  phy->Reg[DP83822_FCSCR] = (uint16_t)((fcscr > DP83822_FCSCR_FCSCNT) ? DP83822_FCSCR_FCSCNT : fcscr);
+}
+
+/**
+  * @brief  Deliver a received frame to the Wake-on-LAN filter of a simulated
+  *         PHY. With WoL enabled and the link up, a frame matching an
+  *         enabled wake source sets RXFS and the WoL interrupt status. A
+  *         magic packet with a wrong SecureOn password only sets the
+  *         SecureOn status bit.
+  * @param  Addr: PHY address
+  * @param  pFrame: frame from the destination address on, without FCS
+  * @param  Len: frame length in bytes
+  * @retval DP83822_WOL_xxx causes the frame set, 0 if it did not match
+  */
+uint32_t DP83822_SIM_SendFrame(uint32_t Addr, const uint8_t *pFrame, uint32_t Len)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[Addr & 31U];
+  uint32_t causes;
+
+  DP83822_SIM_Update();
+
+  if(!phy->Present || !phy->LinkUp || !(phy->Mmd[0][DP83822_RXFCFG] & DP83822_RXFCFG_WOL_EN) || Len < 6U)
+  {
+    return 0;
+  }
+
+  causes = DP83822_SIM_WolMatch(phy, pFrame, Len);
+  if(causes & ~DP83822_WOL_SECURE_ON)
+  {
+    phy->Reg[DP83822_MISR2] |= DP83822_SIM_MISR2_WOL;
+  }
+  phy->Mmd[0][DP83822_RXFS] |= (uint16_t)causes;
+
+  return causes;
+}
+
+/**
+  * @brief  Direct access to a modelled extended register, bypassing the bus.
+  * @param  Addr: PHY address
+  * @param  DevAd: MMD device address, DP83822_MMD_xxx
+  * @param  RegAddr: register address within the MMD
+  * @retval Pointer to the register, NULL if the MMD or address is not modelled
+  */
+uint16_t *DP83822_SIM_ExtReg(uint32_t Addr, uint32_t DevAd, uint32_t RegAddr)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[Addr & 31U];
+  uint32_t mmd;
+
+  switch(DevAd)
+  {
+    case DP83822_MMD_VENDOR:   mmd = 0; break;
+    case DP83822_MMD_PCS:      mmd = 1; break;
+    case DP83822_MMD_AUTONEGO: mmd = 2; break;
+    default:                   return NULL;
+  }
+
+  if(RegAddr >= DP83822_SIM_MMD_SIZE)
+  {
+    return NULL;
+  }
+  return &phy->Mmd[mmd][RegAddr];
+}
+
+/**
+  * @brief  Fill an IO context with the simulator callbacks.
+  * @param  ioctx: IO context to fill
+  * @param  Batch: also provide the ReadBatch/WriteBatch callbacks
+  */
+void DP83822_SIM_GetIOCtx(dp83822_IOCtx_t *ioctx, uint32_t Batch)
+{
+  memset(ioctx, 0, sizeof(*ioctx));
+  ioctx->ReadReg  = DP83822_SIM_ReadReg;
+  ioctx->WriteReg = DP83822_SIM_WriteReg;
+  ioctx->GetTick  = DP83822_SIM_GetTick;
+  ioctx->SetPreamble = DP83822_SIM_SetPreamble;
+
+  if(Batch)
+  {
+    ioctx->ReadBatch  = DP83822_SIM_ReadBatch;
+    ioctx->WriteBatch = DP83822_SIM_WriteBatch;
+  }
+}
+
+/**
+  * @brief  Clear the MDIO cost counters.
+  */
+void DP83822_SIM_ResetCost(void)
+{
+  memset(&DP83822_Sim.Cost, 0, sizeof(DP83822_Sim.Cost));
+  DP83822_Sim.BusNs = 0;
+}
+
+/**
+  * @brief  Get the MDIO cost accumulated since DP83822_SIM_ResetCost().
+  */
+void DP83822_SIM_GetCost(dp83822_SimCost_t *pCost)
+{
+  *pCost = DP83822_Sim.Cost;
+  pCost->BusUs = (uint32_t)(DP83822_Sim.BusNs / 1000U);
+}
+
+/**
+  * @brief  Measure the MDIO cost of the public driver API on a simulated PHY
+  *         with the cable connected, one entry per call.
+  * @param  Flags: DP83822_SIM_BENCH_xxx
+  * @param  pResult: array to hold the measurements
+  * @param  MaxCount: size of pResult, DP83822_SIM_BENCH_MAX covers all calls
+  * @retval Number of entries filled in
+  */
+uint32_t DP83822_SIM_Benchmark(uint32_t Flags, dp83822_SimBench_t *pResult, uint32_t MaxCount)
+{
+  static dp83822_Object_t obj;
+  dp83822_IOCtx_t io;
+  dp83822_Status_t status;
+  uint32_t count = 0, pending = 0, generation = 0, addr = 0, found = 0, regval = 0, cause = 0;
+  uint16_t extregs[16];
+  dp83822_Event_t events[4];
+  dp83822_Counters_t counters;
+  dp83822_AutoNego_t autonego;
+  dp83822_SelfTestCfg_t selftest = { DP83822_BIST_LOOPBACK_PCS_OUTPUT, 0, 0, 10, 0 };
+  dp83822_SelfTestResult_t result;
+  dp83822_CableDiag_t cablediag;
+  dp83822_Sched_t sched;
+  dp83822_Eee_t eee;
+  dp83822_LpiStats_t lpi;
+  dp83822_ProfileResult_t profile;
+  dp83822_WolCfg_t wol;
+  static const dp83822_ProfileEntry_t board[] =
+  {
+    DP83822_PROFILE_REG(DP83822_LEDCR, DP83822_LEDCR_BLINK_RATE, 0x0200U),
+    DP83822_PROFILE_REG(DP83822_PHYCR, DP83822_PHYCR_MDIX_EN | DP83822_PHYCR_LED_CFG, DP83822_PHYCR_MDIX_EN),
+    DP83822_PROFILE_REG(DP83822_RCSR, DP83822_RCSR_RMII_CLK_SEL, DP83822_RCSR_RMII_CLK_SEL),
+    DP83822_PROFILE_EXT(DP83822_MMD_VENDOR, 0x0404U, 0x00FFU, 0x0010U)
+  };
+
+#define DP83822_SIM_BENCH(call)                         \
+  do                                                    \
+  {                                                     \
+    if(count < MaxCount)                                \
+    {                                                   \
+      DP83822_SIM_ResetCost();                          \
+      pResult[count].Name   = #call;                    \
+      pResult[count].Status = (call);                   \
+      DP83822_SIM_GetCost(&pResult[count].Cost);        \
+      count++;                                          \
+    }                                                   \
+  } while(0)
+
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_SetCable(1, 1);
+
+  DP83822_SIM_GetIOCtx(&io, Flags & DP83822_SIM_BENCH_BATCH);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+
+  if(Flags & DP83822_SIM_BENCH_SHADOW)
+  {
+    DP83822_SetShadowMode(&obj, DP83822_SHADOW_ENABLED);
+  }
+
+  DP83822_SIM_BENCH(DP83822_ScanBus(&io, &addr, 1, &found));
+  DP83822_SIM_BENCH(DP83822_Init(&obj));
+  DP83822_SIM_BENCH(DP83822_GetLinkState(&obj));
+  DP83822_SIM_BENCH(DP83822_GetStatus(&obj, &status));
+  DP83822_SIM_BENCH(DP83822_PublishStatus(&obj));
+  DP83822_SIM_BENCH(DP83822_ReadPublishedStatus(&obj, &status, &generation));
+  DP83822_SIM_BENCH(DP83822_ReadEvents(&obj, events, 4, &found, 0));
+  DP83822_SIM_BENCH(DP83822_GetCounters(&obj, &counters));
+  DP83822_SIM_BENCH(DP83822_GetCableLength(&obj, &regval));
+  DP83822_SIM_BENCH(DP83822_SetFastLinkDown(&obj, DP83822_FLD_ENERGY_LOST | DP83822_FLD_DESCRAMBLER_LOSS));
+  DP83822_SIM_BENCH(DP83822_GetLinkDownCause(&obj, &cause));
+  DP83822_SIM_BENCH(DP83822_SetLinkState(&obj, DP83822_STATUS_100MBITS_FULLDUPLEX));
+  DP83822_SIM_BENCH(DP83822_StartAutoNego(&obj));
+  DP83822_SIM_BENCH(DP83822_GetAutoNego(&obj, &autonego));
+  DP83822_SIM_BENCH(DP83822_SetEee(&obj, DP83822_EEE_ENABLED));
+  DP83822_SIM_BENCH(DP83822_GetEee(&obj, &eee));
+  DP83822_SIM_BENCH(DP83822_GetLpiStats(&obj, &lpi));
+  DP83822_SIM_BENCH(DP83822_EnablePowerDownMode(&obj));
+  DP83822_SIM_BENCH(DP83822_DisablePowerDownMode(&obj));
+  DP83822_SIM_BENCH(DP83822_EnableLoopbackMode(&obj));
+  DP83822_SIM_BENCH(DP83822_DisableLoopbackMode(&obj));
+  DP83822_SIM_BENCH(DP83822_StartSelfTest(&obj, &selftest));
+  DP83822_SIM_BENCH(DP83822_PollSelfTest(&obj, &result));
+  DP83822_SIM_BENCH(DP83822_AbortSelfTest(&obj));
+  DP83822_SIM_BENCH(DP83822_StartCableDiag(&obj));
+  DP83822_SIM_BENCH(DP83822_PollCableDiag(&obj, &cablediag));
+  DP83822_SIM_Advance(DP83822_SIM_TDR_TIME_MS);
+  DP83822_SIM_BENCH(DP83822_PollCableDiag(&obj, &cablediag));
+  DP83822_SIM_BENCH(DP83822_EnableIT(&obj, DP83822_LINK_STATUS_CHANGE_IT | DP83822_AUTONEGO_COMPLETE_IT));
+  DP83822_SIM_BENCH(DP83822_GetITStatus(&obj, DP83822_LINK_STATUS_CHANGE_IT));
+  DP83822_SIM_BENCH(DP83822_GetPendingIT(&obj, &pending));
+  DP83822_SIM_BENCH(DP83822_ClearIT(&obj, DP83822_ALL_IT));
+  DP83822_SIM_BENCH(DP83822_DisableIT(&obj, DP83822_ALL_IT));
+  DP83822_SIM_BENCH(DP83822_ReadExtReg(&obj, DP83822_MMD_VENDOR, 0x0000U, &regval));
+  DP83822_SIM_BENCH(DP83822_ReadExtRegs(&obj, DP83822_MMD_VENDOR, 0x0000U, extregs, 16));
+  DP83822_SIM_BENCH(DP83822_ApplyProfile(&obj, board, 4, &profile));
+  DP83822_SIM_BENCH(DP83822_ApplyProfile(&obj, board, 4, &profile));
+  DP83822_SIM_BENCH(DP83822_VerifyProfile(&obj, board, 4, &profile));
+  memset(&wol, 0, sizeof(wol));
+  wol.Modes = DP83822_WOL_MAGIC;
+  wol.Interrupt = 1;
+  DP83822_SIM_BENCH(DP83822_SetWol(&obj, &wol));
+  DP83822_SIM_BENCH(DP83822_GetWolStatus(&obj, &cause));
+  DP83822_SchedInit(&sched, 0, 0);
+  DP83822_SchedAddPort(&sched, &obj);
+  DP83822_SIM_BENCH(DP83822_SchedRun(&sched, &pending));
+  DP83822_SIM_BENCH(DP83822_DeInit(&obj));
+
+#undef DP83822_SIM_BENCH
+
+  return count;
+}
+
+/**
+  * @brief  Measure the time from boot to link up on PHY 1, running the
+  *         non-blocking init with a 1 ms poll period. Resets the simulated bus.
+  * @param  PartnerAbility: link partner abilities, ANLPAR format
+  * @param  FastStart: link state for DP83822_SetFastStart(), 0 for none
+  * @param  FastTimers: DP83822_FAST_xxx options
+  * @param  pLinkUpMs: pointer to hold the simulated time at link up
+  * @retval DP83822_STATUS_OK if the link came up, else the init status
+  */
+int32_t DP83822_SIM_MeasureLinkUp(uint32_t PartnerAbility, uint32_t FastStart, uint32_t FastTimers, uint32_t *pLinkUpMs)
+{
+  static dp83822_Object_t obj;
+  dp83822_IOCtx_t io;
+  int32_t status;
+
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1)->PartnerAbility = PartnerAbility;
+  DP83822_SIM_SetCable(1, 1);
+
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+  DP83822_SetFastStart(&obj, FastStart, 0);
+  DP83822_SetFastTimers(&obj, FastTimers);
+
+  status = DP83822_StartInit(&obj);
+
+  while(status == DP83822_STATUS_OK && obj.InitState != DP83822_INIT_STATE_DONE)
+  {
+    DP83822_SIM_Advance(1);
+    status = DP83822_PollInit(&obj);
+
+    if(status == DP83822_STATUS_BUSY)
+      status = DP83822_STATUS_OK;
+  }
+
+  *pLinkUpMs = (uint32_t)(DP83822_Sim.NowNs / DP83822_SIM_NS_PER_MS);
+  return status;
+}
+
+/**
+  * @brief  Measure the link down latency of a cable unplug on PHY 1 with the
+  *         given fast link down criteria, polling DP83822_GetLinkState()
+  *         every PollMs. Resets the simulated bus.
+  * @param  Criteria: DP83822_FLD_xxx combination, 0 for standard timing
+  * @param  PollMs: link poll period, at least 1
+  * @param  pDetectUs: pointer to hold unplug to PHY link drop (and INTn)
+  * @param  pNotifyUs: pointer to hold unplug to link down reported by polling
+  * @retval DP83822_STATUS_OK if OK, else the failing driver status
+  */
+int32_t DP83822_SIM_MeasureLinkDown(uint32_t Criteria, uint32_t PollMs, uint32_t *pDetectUs, uint32_t *pNotifyUs)
+{
+  static dp83822_Object_t obj;
+  dp83822_IOCtx_t io;
+  uint64_t start;
+  int32_t status;
+
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_SetCable(1, 1);
+
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+
+  if((status = DP83822_Init(&obj)) < 0 || (status = DP83822_SetFastLinkDown(&obj, Criteria)) < 0)
+    return status;
+
+  /* Clear the link latched low by the initial negotiation */
+  DP83822_GetLinkState(&obj);
+
+  start = DP83822_Sim.NowNs;
+  DP83822_SIM_SetCable(1, 0);
+
+  do
+  {
+    DP83822_SIM_Advance(PollMs ? PollMs : 1U);
+    status = DP83822_GetLinkState(&obj);
+  } while(status > DP83822_STATUS_LINK_DOWN);
+
+  *pDetectUs = (uint32_t)((DP83822_Sim.Phy[1].LinkDownNs - start) / 1000U);
+  *pNotifyUs = (uint32_t)((DP83822_Sim.NowNs - start) / 1000U);
+
+  return (status < 0) ? status : DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Run a flap storm on PHY 1 with energy lost fast link down: the
+  *         cable is pulled for 50 ms every FlapPeriodMs, Flaps times, then
+  *         left in for 10 s. The link is polled every 10 ms through the
+  *         debounce filter. Resets the simulated bus.
+  * @param  UpMs: DP83822_SetDebounce() link up window
+  * @param  DownMs: DP83822_SetDebounce() link down window
+  * @param  FlapLimit: DP83822_SetDebounce() drops that start a hold-down
+  * @param  HoldDownMs: DP83822_SetDebounce() hold-down window
+  * @param  Flaps: number of cable pulls
+  * @param  FlapPeriodMs: time between two cable pulls
+  * @param  pRaw: pointer to hold the link up/down events logged
+  * @param  pReported: pointer to hold the link up/down changes reported
+  * @retval DP83822_STATUS_OK if OK, else the failing driver status
+  */
+int32_t DP83822_SIM_MeasureDebounce(uint32_t UpMs, uint32_t DownMs, uint32_t FlapLimit, uint32_t HoldDownMs,
+                                    uint32_t Flaps, uint32_t FlapPeriodMs, uint32_t *pRaw, uint32_t *pReported)
+{
+  static dp83822_Object_t obj;
+  dp83822_IOCtx_t io;
+  dp83822_Event_t events[DP83822_EVENT_LOG_SIZE];
+  uint32_t t, end, i, count, up, last_up;
+  int32_t status;
+
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_SetCable(1, 1);
+
+  DP83822_SIM_GetIOCtx(&io, 1);
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+
+  if((status = DP83822_Init(&obj)) < 0 || (status = DP83822_SetFastLinkDown(&obj, DP83822_FLD_ENERGY_LOST)) < 0 ||
+     (status = DP83822_SetDebounce(&obj, UpMs, DownMs, FlapLimit, HoldDownMs)) < 0)
+    return status;
+
+  /* Settle on the link up and drop the bring-up events */
+  DP83822_GetLinkState(&obj);
+  DP83822_GetLinkState(&obj);
+  DP83822_ReadEvents(&obj, events, DP83822_EVENT_LOG_SIZE, &count, 0);
+  last_up = 1;
+  *pRaw = 0;
+  *pReported = 0;
+
+  end = Flaps * FlapPeriodMs + 10000U;
+  for(t = 0; t < end; t += 10U)
+  {
+    if(t < Flaps * FlapPeriodMs && t % FlapPeriodMs == 0)
+      DP83822_SIM_SetCable(1, 0);
+    if(t < Flaps * FlapPeriodMs && t % FlapPeriodMs == 50U)
+      DP83822_SIM_SetCable(1, 1);
+
+    DP83822_SIM_Advance(10);
+    if((status = DP83822_GetLinkState(&obj)) < 0)
+      return status;
+
+    up = (status >= DP83822_STATUS_100MBITS_FULLDUPLEX && status <= DP83822_STATUS_10MBITS_HALFDUPLEX);
+    if(up != last_up)
+      (*pReported)++;
+    last_up = up;
+
+    DP83822_ReadEvents(&obj, events, DP83822_EVENT_LOG_SIZE, &count, 0);
+    for(i = 0; i < count; i++)
+    {
+      if(events[i].Type == DP83822_EVENT_LINK_UP || events[i].Type == DP83822_EVENT_LINK_DOWN)
+        (*pRaw)++;
+    }
+  }
+
+  return last_up ? DP83822_STATUS_OK : DP83822_STATUS_LINK_DOWN;
+}
+
+/**
+  * @brief  Run a poll scheduler over PHYs 1..Ports for RunMs, calling
+  *         DP83822_SchedRun() every millisecond, while the cable of PHY 1 is
+  *         unplugged for 300 ms halfway through. Equal MinInterval and
+  *         MaxInterval give a fixed rate poll for comparison. Resets the
+  *         simulated bus.
+  * @param  Ports: number of PHYs, 1 to DP83822_SCHED_MAX_PORTS
+  * @param  MinInterval: scheduler fast poll period in ms
+  * @param  MaxInterval: scheduler stable poll period in ms
+  * @param  RunMs: simulated run time after the links came up
+  * @param  pStats: pointer to hold the bus totals of the scheduler
+  * @retval DP83822_STATUS_OK if OK, else the failing driver status
+  */
+int32_t DP83822_SIM_MeasureSched(uint32_t Ports, uint32_t MinInterval, uint32_t MaxInterval, uint32_t RunMs,
+                                 dp83822_SchedStats_t *pStats)
+{
+  static dp83822_Object_t obj[DP83822_SCHED_MAX_PORTS];
+  static dp83822_Sched_t sched;
+  dp83822_IOCtx_t io;
+  uint32_t i, changed;
+  int32_t status;
+
+  if(Ports == 0 || Ports > DP83822_SCHED_MAX_PORTS)
+    return DP83822_STATUS_ERROR;
+
+  DP83822_SIM_Init();
+  DP83822_SIM_GetIOCtx(&io, 1);
+
+  for(i = 0; i < Ports; i++)
+  {
+    DP83822_SIM_AddPhy(i + 1U);
+    DP83822_SIM_SetCable(i + 1U, 1);
+    memset(&obj[i], 0, sizeof(obj[i]));
+    DP83822_RegisterBusIO(&obj[i], &io);
+    obj[i].AddrHint = i + 1U;
+    if((status = DP83822_Init(&obj[i])) < 0)
+      return status;
+  }
+
+  if((status = DP83822_SchedInit(&sched, MinInterval, MaxInterval)) < 0)
+    return status;
+  for(i = 0; i < Ports; i++)
+    DP83822_SchedAddPort(&sched, &obj[i]);
+
+  for(i = 0; i < RunMs; i++)
+  {
+    if(i == RunMs / 2U)
+      DP83822_SIM_SetCable(1, 0);
+    if(i == RunMs / 2U + 300U)
+      DP83822_SIM_SetCable(1, 1);
+
+    DP83822_SIM_Advance(1);
+    if((status = DP83822_SchedRun(&sched, &changed)) < 0)
+      return status;
+  }
+
+  return DP83822_SchedGetStats(&sched, DP83822_SCHED_ALL_PORTS, pStats);
+}
+
+/**
+  * @brief  Read a register of the simulated bus (dp83822_IOCtx_t ReadReg).
+  *         Addresses without a PHY read back as 0xFFFF like a pulled-up MDIO.
+  */
+int32_t DP83822_SIM_ReadReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t *pRegVal)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[DevAddr & 31U];
+  uint32_t val;
+
+  DP83822_SIM_Frame(DevAddr);
+  DP83822_Sim.Cost.Reads++;
+
+  if(DP83822_Sim.ReadErrors)
+  {
+    DP83822_Sim.ReadErrors--;
+    return -1;
+  }
+
+  if(DevAddr > 31U || RegAddr > 31U || !phy->Present)
+  {
+    *pRegVal = 0xFFFFU;
+    return 0;
+  }
+
+  val = phy->Reg[RegAddr];
+
+  switch(RegAddr)
+  {
+    case DP83822_BMSR:
+      if(phy->LinkUp && !phy->LinkLatchedLow)
+        val |= DP83822_BMSR_LINK_STATUS;
+      if(phy->LinkUp && (phy->Reg[DP83822_BMCR] & DP83822_BMCR_AUTONEGO_EN))
+        val |= DP83822_SIM_BMSR_AUTONEGO_CPLT;
+      phy->LinkLatchedLow = 0;
+      break;
+
+    case DP83822_PHYSTS:
+      val = 0;
+      if(phy->LinkUp)
+      {
+        val = DP83822_PHYSTS_LINK_STATUS | phy->Resolved;
+        if(phy->CableConnected)
+          val |= DP83822_PHYSTS_SIGNAL_DETECT | DP83822_PHYSTS_DESCRAMBLER_LOCK;
+        if(phy->Reg[DP83822_BMCR] & DP83822_BMCR_AUTONEGO_EN)
+          val |= DP83822_PHYSTS_AUTONEGO_DONE;
+      }
+      val |= phy->PhystsLatch;
+      phy->PhystsLatch = 0;
+      break;
+
+    case DP83822_MISR1:
+    case DP83822_MISR2:
+      /* Status bits are clear-on-read */
+      phy->Reg[RegAddr] &= DP83822_MISR_INT_EN_MASK;
+      break;
+
+    case DP83822_MMDAADR:
+      val = DP83822_SIM_ExtAccess(phy, 0, 0);
+      break;
+
+    case DP83822_FCSCR:
+    case DP83822_RECR:
+      /* Counters are clear-on-read */
+      phy->Reg[RegAddr] = 0;
+      break;
+
+    case DP83822_BISCR:
+      if(DP83822_SIM_BistLocked(phy))
+        val |= DP83822_BISCR_PRBS_LOCK | DP83822_BISCR_PACKET_GEN_BUSY;
+      break;
+
+    case DP83822_BICSR1:
+      if(phy->Reg[DP83822_BISCR] & DP83822_BISCR_PACKET_GEN_EN)
+      {
+        /* Errors since the generator started, moved to the clear-on-read counter */
+        uint64_t total = (DP83822_Sim.NowNs - phy->BistStartNs) * phy->BistErrorRate /
+                         (1000U * DP83822_SIM_NS_PER_MS);
+        uint64_t count = DP83822_SIM_BistLocked(phy) ? total - phy->BistErrors : 0;
+
+        phy->BistErrors = total;
+        if(phy->Reg[DP83822_BISCR] & DP83822_BISCR_ERR_CNT_MODE)
+          count &= 0xFFU;
+        else if(count > 0xFFU)
+          count = 0xFFU;
+        val |= (uint32_t)count << 8;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  *pRegVal = val;
+  return 0;
+}
+
+/**
+  * @brief  Write a register of the simulated bus (dp83822_IOCtx_t WriteReg).
+  */
+int32_t DP83822_SIM_WriteReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[DevAddr & 31U];
+  uint32_t old;
+
+  DP83822_SIM_Frame(DevAddr);
+  DP83822_Sim.Cost.Writes++;
+
+  if(DevAddr > 31U || RegAddr > 31U || !phy->Present)
+  {
+    return 0;
+  }
+
+  RegVal &= 0xFFFFU;
+
+  switch(RegAddr)
+  {
+    case DP83822_BMCR:
+      if(RegVal & DP83822_BMCR_SOFT_RESET)
+      {
+        DP83822_SIM_ResetPhy(phy);
+        phy->Reg[DP83822_BMCR] |= DP83822_BMCR_SOFT_RESET;
+        phy->ResetDoneNs = DP83822_Sim.NowNs + (uint64_t)phy->ResetTimeMs * DP83822_SIM_NS_PER_MS;
+        break;
+      }
+
+      old = phy->Reg[DP83822_BMCR];
+      phy->Reg[DP83822_BMCR] = (uint16_t)(RegVal & ~DP83822_BMCR_RESTART_AUTONEGO);
+
+      if(phy->ResetDoneNs == 0 &&
+         ((RegVal & DP83822_BMCR_RESTART_AUTONEGO) ||
+          ((old ^ RegVal) & (DP83822_BMCR_AUTONEGO_EN | DP83822_BMCR_SPEED_SELECT |
+                             DP83822_BMCR_DUPLEX_MODE | DP83822_BMCR_POWER_DOWN))))
+      {
+        /* Link is renegotiated */
+        DP83822_SIM_LinkDown(phy);
+        DP83822_SIM_ScheduleLink(phy);
+      }
+      break;
+
+    case DP83822_MISR1:
+    case DP83822_MISR2:
+      phy->Reg[RegAddr] = (uint16_t)((phy->Reg[RegAddr] & DP83822_MISR_INT_STAT_MASK) |
+                                     (RegVal & DP83822_MISR_INT_EN_MASK));
+      break;
+
+    case DP83822_MMDACR:
+      phy->Reg[RegAddr] = (uint16_t)RegVal;
+      phy->MmdDevAd    = RegVal & DP83822_MMDACR_MMD_DEV_ADDR;
+      phy->MmdFunction = RegVal & DP83822_MMDACR_MMD_FUNCTION;
+      break;
+
+    case DP83822_MMDAADR:
+      DP83822_SIM_ExtAccess(phy, 1, RegVal);
+      break;
+
+    case DP83822_BISCR:
+      if((RegVal & DP83822_BISCR_PACKET_GEN_EN) && !(phy->Reg[DP83822_BISCR] & DP83822_BISCR_PACKET_GEN_EN))
+      {
+        phy->BistStartNs = DP83822_Sim.NowNs;
+        phy->BistErrors  = 0;
+      }
+      phy->Reg[RegAddr] = (uint16_t)(RegVal & (DP83822_BISCR_ERR_CNT_MODE | DP83822_BISCR_PACKET_GEN_EN |
+                                               DP83822_BISCR_LOOPBACK_MASK));
+      break;
+
+    case DP83822_BICSR1:
+      phy->Reg[RegAddr] = (uint16_t)(RegVal & DP83822_BICSR1_IPG_LENGTH);
+      break;
+
+    case DP83822_CDCR:
+      if((RegVal & DP83822_CDCR_DIAG_START) && phy->ResetDoneNs == 0)
+      {
+        /* The TDR pulses replace the link until the results are in */
+        DP83822_SIM_LinkDown(phy);
+        phy->Reg[RegAddr] = DP83822_CDCR_DIAG_START;
+        phy->TdrDoneNs = DP83822_Sim.NowNs + (uint64_t)phy->TdrTimeMs * DP83822_SIM_NS_PER_MS;
+      }
+      break;
+
+    case DP83822_BMSR:
+    case DP83822_PHYI1R:
+    case DP83822_PHYI2R:
+    case DP83822_PHYSTS:
+    case DP83822_FCSCR:
+    case DP83822_RECR:
+    case DP83822_ANLPAR:
+    case DP83822_ANER:
+      /* Read-only */
+      break;
+
+    default:
+      phy->Reg[RegAddr] = (uint16_t)RegVal;
+      break;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Enable or disable preamble suppression towards a PHY
+  *         (dp83822_IOCtx_t SetPreamble). Refused if the PHY does not
+  *         advertise MF preamble suppression in BMSR.
+  */
+int32_t DP83822_SIM_SetPreamble(uint32_t DevAddr, uint32_t Suppress)
+{
+  dp83822_SimPhy_t *phy = &DP83822_Sim.Phy[DevAddr & 31U];
+
+  if(Suppress && !(phy->Reg[DP83822_BMSR] & DP83822_BMSR_MF_PREAMBLE))
+  {
+    return -1;
+  }
+
+  phy->PreambleSuppressed = (Suppress != 0);
+  return 0;
+}
+
+/**
+  * @brief  Simulated millisecond tick (dp83822_IOCtx_t GetTick).
+  */
+int32_t DP83822_SIM_GetTick(void)
+{
+  return (int32_t)(DP83822_Sim.NowNs / DP83822_SIM_NS_PER_MS);
+}
+
+/**
+  * @brief  Batched read (dp83822_IOCtx_t ReadBatch), one job of Count frames.
+  */
+int32_t DP83822_SIM_ReadBatch(uint32_t DevAddr, dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  int32_t status = 0;
+  uint32_t i;
+
+  DP83822_Sim.Cost.Jobs++;
+
+  for(i = 0; i < Count; i++)
+  {
+    if(DP83822_SIM_ReadReg(DevAddr, pOps[i].RegAddr, &pOps[i].RegVal) < 0)
+      status = -1;
+  }
+  return status;
+}
+
+/**
+  * @brief  Batched write (dp83822_IOCtx_t WriteBatch), one job of Count frames.
+  */
+int32_t DP83822_SIM_WriteBatch(uint32_t DevAddr, const dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  uint32_t i;
+
+  DP83822_Sim.Cost.Jobs++;
+
+  for(i = 0; i < Count; i++)
+  {
+    DP83822_SIM_WriteReg(DevAddr, pOps[i].RegAddr, pOps[i].RegVal);
+  }
+  return 0;
+}
+
+/**
+  * @brief  Account one MDIO frame and let the PHY models progress. Frames
+  *         to a PHY with preamble suppression enabled skip the preamble.
+  */
+static void DP83822_SIM_Frame(uint32_t DevAddr)
+{
+  uint32_t clocks = DP83822_Sim.FrameClocks;
+  uint64_t ns;
+
+  if(DP83822_Sim.Phy[DevAddr & 31U].PreambleSuppressed)
+  {
+    clocks -= DP83822_SIM_PREAMBLE_CLOCKS;
+  }
+
+  ns = ((uint64_t)clocks * 1000000000U) / DP83822_Sim.MdcHz;
+
+  DP83822_Sim.NowNs += ns;
+  DP83822_Sim.BusNs += ns;
+  DP83822_SIM_Update();
+}
+
+/**
+  * @brief  Complete resets and scheduled link ups that are due.
+  */
+static void DP83822_SIM_Update(void)
+{
+  dp83822_SimPhy_t *phy;
+  uint32_t addr, resolved;
+
+  for(addr = 0; addr <= 31U; addr++)
+  {
+    phy = &DP83822_Sim.Phy[addr];
+
+    if(!phy->Present)
+      continue;
+
+    if(phy->ResetDoneNs && DP83822_Sim.NowNs >= phy->ResetDoneNs)
+    {
+      phy->ResetDoneNs = 0;
+      phy->Reg[DP83822_BMCR] &= ~DP83822_BMCR_SOFT_RESET;
+      DP83822_SIM_ScheduleLink(phy);
+    }
+
+    if(phy->TdrDoneNs && DP83822_Sim.NowNs >= phy->TdrDoneNs)
+    {
+      phy->TdrDoneNs = 0;
+      DP83822_SIM_TdrResult(phy);
+      phy->Reg[DP83822_CDCR] = DP83822_CDCR_DIAG_DONE;
+      DP83822_SIM_ScheduleLink(phy);
+    }
+
+    if(phy->LinkDownAtNs && DP83822_Sim.NowNs >= phy->LinkDownAtNs)
+    {
+      uint64_t at = phy->LinkDownAtNs;
+
+      DP83822_SIM_LinkDown(phy);
+      phy->LinkDownNs = at;
+    }
+
+    if(phy->LinkUpAtNs && DP83822_Sim.NowNs >= phy->LinkUpAtNs)
+    {
+      phy->LinkUpAtNs = 0;
+      resolved = DP83822_SIM_Resolve(phy);
+
+      if(resolved != DP83822_SIM_NO_LINK)
+      {
+        if(resolved != phy->Resolved)
+        {
+          phy->Reg[DP83822_MISR1] |= DP83822_SIM_MISR1_SPEED | DP83822_SIM_MISR1_DUPLEX;
+        }
+        phy->Resolved = resolved;
+        phy->LinkUp   = 1;
+
+        /* The equalizer adapts to the cable loss on a 100 Mbit/s link */
+        if(!(resolved & DP83822_PHYSTS_SPEED_MASK))
+        {
+          uint32_t eq = phy->CableLengthCm / DP83822_CABLE_CM_PER_EQ_STEP;
+          phy->Mmd[0][DP83822_DSP_EQ_STATUS] = (uint16_t)((eq > DP83822_DSP_EQ_SETTING) ? DP83822_DSP_EQ_SETTING : eq);
+        }
+        phy->Reg[DP83822_MISR1] |= DP83822_SIM_MISR1_LINK;
+
+        if(phy->Reg[DP83822_BMCR] & DP83822_BMCR_AUTONEGO_EN)
+        {
+          phy->Reg[DP83822_MISR1] |= DP83822_SIM_MISR1_AUTONEGO;
+          phy->Reg[DP83822_ANLPAR] = (uint16_t)phy->PartnerAbility;
+          phy->Reg[DP83822_ANER]   = DP83822_ANER_LP_AUTONEG_ABLE;
+
+          /* EEE needs both advertisements and 100BASE-TX full duplex */
+          phy->Mmd[2][DP83822_EEE_LP_ABILITY] = (uint16_t)phy->PartnerEee;
+          phy->EeeActive = (phy->Mmd[2][DP83822_EEE_ADVERTISE] & phy->PartnerEee & DP83822_EEE_100BASE_TX) &&
+                           resolved == DP83822_PHYSTS_DUPLEX_MASK;
+          phy->LpiBaseNs = DP83822_Sim.NowNs;
+          phy->LpiReadNs = DP83822_Sim.NowNs;
+        }
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Load the power-on register values.
+  */
+static void DP83822_SIM_ResetPhy(dp83822_SimPhy_t *phy)
+{
+  DP83822_SIM_LinkDown(phy);
+  memset(phy->Reg, 0, sizeof(phy->Reg));
+  phy->Reg[DP83822_BMCR]     = DP83822_SIM_BMCR_DEFAULT;
+  phy->Reg[DP83822_BMSR]     = DP83822_SIM_BMSR_DEFAULT;
+  phy->Reg[DP83822_PHYI1R]   = DP83822_PHYI1R_OUI_3_18;
+  phy->Reg[DP83822_PHYI2R]   = DP83822_PHYI2R_ID;
+  phy->Reg[DP83822_ANAR]     = DP83822_SIM_ANAR_DEFAULT;
+  phy->Reg[DP83822_PHYSCR]   = DP83822_SIM_PHYSCR_DEFAULT;
+  phy->Reg[DP83822_RCSR]     = DP83822_SIM_RCSR_DEFAULT;
+  phy->Reg[DP83822_PHYCR]    = (uint16_t)(DP83822_SIM_PHYCR_DEFAULT | (uint32_t)(phy - DP83822_Sim.Phy));
+  memset(phy->Mmd, 0, sizeof(phy->Mmd));
+  phy->Mmd[1][DP83822_EEE_CAPABILITY] = DP83822_EEE_100BASE_TX;
+  phy->MmdDevAd       = 0;
+  phy->MmdFunction    = 0;
+  phy->MmdAddr        = 0;
+  phy->LinkLatchedLow = 0;
+  phy->PhystsLatch    = 0;
+  phy->ResetDoneNs    = 0;
+  phy->TdrDoneNs      = 0;
+}
+
+/**
+  * @brief  Drop the link, latching BMSR link status low.
+  */
+static void DP83822_SIM_LinkDown(dp83822_SimPhy_t *phy)
+{
+  if(phy->LinkUp)
+  {
+    phy->LinkUp = 0;
+    phy->LinkLatchedLow = 1;
+    phy->LinkDownNs = DP83822_Sim.NowNs;
+    phy->Reg[DP83822_MISR1] |= DP83822_SIM_MISR1_LINK;
+  }
+  phy->Reg[DP83822_ANLPAR] = 0;
+  phy->Reg[DP83822_ANER]   = 0;
+  phy->Mmd[0][DP83822_DSP_EQ_STATUS] = 0;
+  phy->Mmd[2][DP83822_EEE_LP_ABILITY] = 0;
+  phy->EeeActive = 0;
+  phy->LinkUpAtNs = 0;
+  phy->LinkDownAtNs = 0;
+}
+
+/**
+  * @brief  Schedule the link to come up per the current BMCR mode.
+  */
+static void DP83822_SIM_ScheduleLink(dp83822_SimPhy_t *phy)
+{
+  uint32_t bmcr = phy->Reg[DP83822_BMCR];
+  uint32_t ms;
+
+  if(!phy->CableConnected || phy->ResetDoneNs || phy->TdrDoneNs || (bmcr & DP83822_BMCR_POWER_DOWN))
+  {
+    return;
+  }
+
+  if(!(bmcr & DP83822_BMCR_AUTONEGO_EN))
+    ms = phy->ForcedLinkTimeMs;
+  else if(phy->Reg[DP83822_CR1] & DP83822_CR1_FAST_AUTONEGO_EN)
+    ms = phy->FastAutoNegoTimeMs;
+  else
+    ms = phy->AutoNegoTimeMs;
+  phy->LinkUpAtNs = DP83822_Sim.NowNs + (uint64_t)ms * DP83822_SIM_NS_PER_MS;
+}
+
+/**
+  * @brief  Resolve speed/duplex as PHYSTS bits [2:1].
+  * @retval PHYSTS bits, DP83822_SIM_NO_LINK if no common ability
+  */
+static uint32_t DP83822_SIM_Resolve(dp83822_SimPhy_t *phy)
+{
+  uint32_t bmcr = phy->Reg[DP83822_BMCR];
+  uint32_t common;
+
+  if(!(bmcr & DP83822_BMCR_AUTONEGO_EN))
+  {
+    /* Partner must be able to run the forced speed, duplex is not checked */
+    if(!(phy->PartnerAbility & ((bmcr & DP83822_BMCR_SPEED_SELECT) ? (DP83822_ANAR_100BASE_TX_FD | DP83822_ANAR_100BASE_TX)
+                                                              : (DP83822_ANAR_10BASE_T_FD | DP83822_ANAR_10BASE_T))))
+      return DP83822_SIM_NO_LINK;
+
+    return ((bmcr & DP83822_BMCR_SPEED_SELECT) ? 0U : DP83822_PHYSTS_SPEED_MASK) |
+           ((bmcr & DP83822_BMCR_DUPLEX_MODE) ? DP83822_PHYSTS_DUPLEX_MASK : 0U);
+  }
+
+  common = phy->Reg[DP83822_ANAR] & phy->PartnerAbility & DP83822_ANAR_TECHNOLOGY_MASK;
+
+  if(common & DP83822_ANAR_100BASE_TX_FD)
+    return DP83822_PHYSTS_DUPLEX_MASK;
+  if(common & DP83822_ANAR_100BASE_TX)
+    return 0U;
+  if(common & DP83822_ANAR_10BASE_T_FD)
+    return DP83822_PHYSTS_SPEED_MASK | DP83822_PHYSTS_DUPLEX_MASK;
+  if(common & DP83822_ANAR_10BASE_T)
+    return DP83822_PHYSTS_SPEED_MASK;
+
+  return DP83822_SIM_NO_LINK;
+}
+
+/**
+  * @brief  MMDAADR access per the MMDACR function set up last: address,
+  *         data, data with post increment, data with post increment on
+  *         write. Unmodelled extended registers read 0 and ignore writes.
+  * @retval Value read
+  */
+static uint32_t DP83822_SIM_ExtAccess(dp83822_SimPhy_t *phy, uint32_t Write, uint32_t RegVal)
+{
+  uint16_t *reg;
+  uint32_t val = 0;
+
+  if(phy->MmdFunction == DP83822_MMDACR_MMD_FUNCTION_ADDR)
+  {
+    if(Write)
+      phy->MmdAddr = RegVal;
+    return phy->MmdAddr;
+  }
+
+  reg = DP83822_SIM_ExtReg((uint32_t)(phy - DP83822_Sim.Phy), phy->MmdDevAd, phy->MmdAddr);
+
+  if(Write)
+  {
+    /* PCS status, EEE capability and wake errors, partner EEE ability, WoL status are read-only */
+    if(reg != NULL && !(phy->MmdDevAd == DP83822_MMD_PCS && (phy->MmdAddr == DP83822_PCS_STATUS1 ||
+                                                             phy->MmdAddr == DP83822_EEE_CAPABILITY ||
+                                                             phy->MmdAddr == DP83822_EEE_WAKE_ERRORS)) &&
+       !(phy->MmdDevAd == DP83822_MMD_AUTONEGO && phy->MmdAddr == DP83822_EEE_LP_ABILITY) &&
+       !(phy->MmdDevAd == DP83822_MMD_VENDOR && phy->MmdAddr == DP83822_RXFS))
+      *reg = (uint16_t)RegVal;
+
+    /* The self-clearing WoL clear bit releases the wake indication */
+    if(phy->MmdDevAd == DP83822_MMD_VENDOR && phy->MmdAddr == DP83822_RXFCFG &&
+       (RegVal & DP83822_RXFCFG_WOL_OUT_CLEAR))
+    {
+      *reg &= (uint16_t)~DP83822_RXFCFG_WOL_OUT_CLEAR;
+      phy->Mmd[0][DP83822_RXFS] = 0;
+    }
+  }
+  else if(reg != NULL)
+  {
+    if(phy->MmdDevAd == DP83822_MMD_PCS && phy->MmdAddr == DP83822_PCS_STATUS1)
+      *reg = (uint16_t)DP83822_SIM_LpiStatus(phy);
+
+    val = *reg;
+
+    if(phy->MmdDevAd == DP83822_MMD_PCS && phy->MmdAddr == DP83822_EEE_WAKE_ERRORS)
+      *reg = 0;
+  }
+
+  if(phy->MmdFunction == DP83822_MMDACR_MMD_FUNCTION_DATA_PI ||
+     (Write && phy->MmdFunction == DP83822_MMDACR_MMD_FUNCTION_DATA_PIW))
+  {
+    phy->MmdAddr = (phy->MmdAddr + 1U) & 0xFFFFU;
+  }
+
+  return val;
+}
+
+/**
+  * @brief  The PRBS checker locks while the generator runs into a near end
+  *         loopback, or into a reverse loopback with the link up.
+  */
+static uint32_t DP83822_SIM_BistLocked(dp83822_SimPhy_t *phy)
+{
+  uint32_t biscr = phy->Reg[DP83822_BISCR];
+
+  if(!(biscr & DP83822_BISCR_PACKET_GEN_EN) || !(biscr & DP83822_BISCR_LOOPBACK_MASK))
+    return 0;
+
+  if(biscr & DP83822_BIST_LOOPBACK_REVERSE)
+    return phy->LinkUp;
+
+  return 1;
+}
+
+/**
+  * @brief  Load the cable diagnostic result registers: one reflection per
+  *         faulty pair as its first peak, an unplugged cable is open at its
+  *         far end, a connected one is matched.
+  */
+static void DP83822_SIM_TdrResult(dp83822_SimPhy_t *phy)
+{
+  uint16_t *regs = &phy->Mmd[0][DP83822_CDLRR1];
+  uint32_t pair, fault, cm, idx, shift, loc;
+
+  memset(regs, 0, DP83822_CABLE_DIAG_REG_NB * sizeof(uint16_t));
+
+  for(pair = 0; pair < DP83822_CABLE_PAIR_NB; pair++)
+  {
+    fault = phy->PairFault[pair];
+    cm    = phy->PairFaultCm[pair];
+    if(fault == DP83822_CABLE_UNKNOWN)
+    {
+      fault = phy->CableConnected ? DP83822_CABLE_MATCH : DP83822_CABLE_OPEN;
+      cm    = phy->CableLengthCm;
+    }
+    if(fault == DP83822_CABLE_MATCH)
+      continue;
+
+    idx   = pair * DP83822_CDLRR_NB;
+    shift = (idx & 1U) * 8U;
+    loc   = (cm + DP83822_TDR_CM_PER_STEP / 2U) / DP83822_TDR_CM_PER_STEP;
+    if(loc > DP83822_CDLRR_LOCATION)
+      loc = DP83822_CDLRR_LOCATION;
+
+    regs[idx / 2U] |= (uint16_t)(loc << shift);
+    regs[DP83822_CDLRR_NB + idx / 2U] |= (uint16_t)(DP83822_SIM_TDR_AMPLITUDE << shift);
+    if(fault == DP83822_CABLE_OPEN)
+      regs[2U * DP83822_CDLRR_NB] |= (uint16_t)(1U << idx);
+  }
+}
+
+/**
+  * @brief  PCS status 1 LPI bits of the modelled traffic: each cycle is
+  *         busy for LpiBusyMs, then in LPI for LpiIdleMs while EEE is
+  *         active. Both paths follow the same pattern. The "LPI received"
+  *         bits latch any LPI since the previous read.
+  * @retval PCS status 1 value
+  */
+static uint32_t DP83822_SIM_LpiStatus(dp83822_SimPhy_t *phy)
+{
+  uint64_t busy = (uint64_t)phy->LpiBusyMs * DP83822_SIM_NS_PER_MS;
+  uint64_t period = busy + (uint64_t)phy->LpiIdleMs * DP83822_SIM_NS_PER_MS;
+  uint64_t now = DP83822_Sim.NowNs - phy->LpiBaseNs, last = phy->LpiReadNs - phy->LpiBaseNs;
+  uint32_t status = 0;
+
+  phy->LpiReadNs = DP83822_Sim.NowNs;
+
+  if(!phy->LinkUp || !phy->EeeActive || phy->LpiIdleMs == 0)
+    return 0;
+
+  if(now % period >= busy)
+    status |= DP83822_PCS_STATUS1_TX_LPI_IND | DP83822_PCS_STATUS1_RX_LPI_IND;
+
+  /* LPI periods started up to a time, compared between the two reads */
+  if(status || ((now >= busy) ? (now - busy) / period + 1U : 0U) != ((last >= busy) ? (last - busy) / period + 1U : 0U))
+    status |= DP83822_PCS_STATUS1_TX_LPI_RCVD | DP83822_PCS_STATUS1_RX_LPI_RCVD;
+
+  return status;
+}
+
+/**
+  * @brief  Match a frame against the enabled wake sources: broadcast or
+  *         station destination, a magic packet (6 x 0xFF then 16 copies of
+  *         the station address anywhere in the frame, followed by the
+  *         password with SecureOn) and the masked pattern.
+  * @retval DP83822_WOL_xxx causes
+  */
+static uint32_t DP83822_SIM_WolMatch(dp83822_SimPhy_t *phy, const uint8_t *pFrame, uint32_t Len)
+{
+  const uint16_t *mmd = phy->Mmd[0];
+  uint32_t cfg = mmd[DP83822_RXFCFG], causes = 0, broadcast = 1, unicast = 1, i, j;
+  uint32_t offset = mmd[DP83822_RXFPATC] & DP83822_RXFPATC_START;
+  uint8_t mac[6], password[6];
+
+  for(i = 0; i < 6U; i++)
+  {
+    mac[i]      = (uint8_t)(mmd[DP83822_RXFPMD1 + i / 2U] >> (8U * (i & 1U)));
+    password[i] = (uint8_t)(mmd[DP83822_RXFSOP1 + i / 2U] >> (8U * (i & 1U)));
+    broadcast  &= (pFrame[i] == 0xFFU);
+    unicast    &= (pFrame[i] == mac[i]);
+  }
+
+  if((cfg & DP83822_WOL_BROADCAST) && broadcast)
+    causes |= DP83822_WOL_BROADCAST;
+  if((cfg & DP83822_WOL_UNICAST) && unicast)
+    causes |= DP83822_WOL_UNICAST;
+
+  if(cfg & DP83822_WOL_MAGIC)
+  {
+    for(i = 0; i + 102U <= Len; i++)
+    {
+      for(j = 0; j < 102U; j++)
+      {
+        if(pFrame[i + j] != ((j < 6U) ? 0xFFU : mac[(j - 6U) % 6U]))
+          break;
+      }
+      if(j == 102U)
+        break;
+    }
+
+    if(i + 102U <= Len)
+    {
+      if(!(cfg & DP83822_WOL_SECURE_ON))
+        causes |= DP83822_WOL_MAGIC;
+      else if(i + 108U <= Len && memcmp(&pFrame[i + 102U], password, 6U) == 0)
+        causes |= DP83822_WOL_MAGIC;
+      else
+        causes |= DP83822_WOL_SECURE_ON;
+    }
+  }
+
+  if(cfg & DP83822_WOL_PATTERN)
+  {
+    for(i = 0; i < DP83822_WOL_PATTERN_SIZE; i++)
+    {
+      if(!(mmd[DP83822_RXFPBM1 + i / 16U] & (1U << (i & 15U))))
+        continue;
+      if(offset + i >= Len ||
+         pFrame[offset + i] != (uint8_t)(mmd[DP83822_RXFPAT1 + i / 2U] >> (8U * (i & 1U))))
+        break;
+    }
+    if(i == DP83822_WOL_PATTERN_SIZE)
+      causes |= DP83822_WOL_PATTERN;
+  }
+
+  return causes;
+}
@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_sim.h
+  * @author  Knut A. Korneliussen
+  * @brief   Host-side simulated DP83822 MDIO bus for the DP83822 PHY driver.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. The model plugs into the driver through
+  * dp83822_IOCtx_t and builds on any hosted C99 toolchain, no HAL required.
+  *
+  ******************************************************************************
+  */
+
+#ifndef DP83822_SIM_H
+#define DP83822_SIM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include <dp83822.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define DP83822_SIM_MDC_HZ_DEFAULT        ((uint32_t)2500000U)  /*!< STM32H7 MDC clock */
+#define DP83822_SIM_FRAME_CLOCKS          ((uint32_t)64U)       /*!< 32-bit preamble + 32-bit frame */
+#define DP83822_SIM_PREAMBLE_CLOCKS       ((uint32_t)32U)
+#define DP83822_SIM_RESET_TIME_MS         ((uint32_t)2U)
+#define DP83822_SIM_AUTONEGO_TIME_MS      ((uint32_t)1500U)
+#define DP83822_SIM_FAST_AUTONEGO_TIME_MS ((uint32_t)500U)      /*!< With CR1 fast autonegotiation */
+#define DP83822_SIM_FORCED_LINK_TIME_MS   ((uint32_t)100U)
+#define DP83822_SIM_LINK_LOSS_TIME_MS     ((uint32_t)250U)      /*!< Link fail detection, standard timers */
+#define DP83822_SIM_FAST_LINK_DOWN_US     ((uint32_t)10U)       /*!< Link fail detection, fast link down */
+#define DP83822_SIM_PARTNER_ABILITY       ((uint32_t)0x05E1U)   /*!< 10/100 HD/FD + symmetric pause */
+#define DP83822_SIM_TDR_TIME_MS           ((uint32_t)5U)        /*!< TDR measurement duration */
+#define DP83822_SIM_CABLE_LENGTH_CM       ((uint32_t)3000U)
+#define DP83822_SIM_TDR_AMPLITUDE         ((uint32_t)40U)       /*!< Reflection amplitude of a modelled fault */
+#define DP83822_SIM_LPI_BUSY_MS           ((uint32_t)2U)        /*!< Traffic burst of the idle pattern */
+#define DP83822_SIM_LPI_IDLE_MS           ((uint32_t)8U)        /*!< Idle time between bursts, spent in LPI with EEE */
+
+/* DP83822_SIM_Benchmark() flags */
+#define DP83822_SIM_BENCH_BATCH           ((uint32_t)0x0001U)   /*!< Register ReadBatch/WriteBatch */
+#define DP83822_SIM_BENCH_SHADOW          ((uint32_t)0x0002U)   /*!< Enable the control register shadow */
+
+#define DP83822_SIM_BENCH_MAX             48U
+
+/* Modelled extended register space, MMD 0x1F/3/7 registers 0x0000..0x0FFF */
+#define DP83822_SIM_MMD_NB                3U
+#define DP83822_SIM_MMD_SIZE              0x1000U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t  Reads;          /*!< MDIO read frames */
+  uint32_t  Writes;         /*!< MDIO write frames */
+  uint32_t  Jobs;           /*!< ReadBatch/WriteBatch jobs */
+  uint32_t  BusUs;          /*!< Simulated MDIO bus time in microseconds */
+} dp83822_SimCost_t;
+
+typedef struct
+{
+  /* Configuration, may be changed after DP83822_SIM_AddPhy() */
+  uint32_t  ResetTimeMs;        /*!< Soft reset duration */
+  uint32_t  AutoNegoTimeMs;     /*!< Restart of autonegotiation to link up */
+  uint32_t  FastAutoNegoTimeMs; /*!< Same with the CR1 fast autonegotiation timers */
+  uint32_t  ForcedLinkTimeMs;   /*!< Forced mode change to link up */
+  uint32_t  LinkLossTimeMs;     /*!< Cable unplug to link down without fast link down */
+  uint32_t  PartnerAbility;     /*!< Link partner base page, ANLPAR format, also limits forced modes */
+  uint32_t  BistErrorRate;      /*!< Errored bytes per second seen by the BIST PRBS checker */
+  uint32_t  TdrTimeMs;          /*!< Cable diagnostic start to results valid */
+  uint32_t  CableLengthCm;      /*!< Cable length, sets the equalizer and the open of an unplugged cable */
+  uint32_t  PairFault[DP83822_CABLE_PAIR_NB];   /*!< DP83822_CABLE_xxx, UNKNOWN derives it from the cable */
+  uint32_t  PairFaultCm[DP83822_CABLE_PAIR_NB]; /*!< Distance of an open or short */
+  uint32_t  PartnerEee;         /*!< Link partner EEE advertisement, DP83822_EEE_ADVERTISE format */
+  uint32_t  LpiBusyMs;          /*!< Traffic pattern: busy time of each cycle */
+  uint32_t  LpiIdleMs;          /*!< Traffic pattern: idle time of each cycle, 0 for no LPI */
+
+  /* Model state */
+  uint32_t  Present;
+  uint32_t  CableConnected;
+  uint32_t  LinkUp;
+  uint32_t  LinkLatchedLow;     /*!< BMSR link status latched low since last read */
+  uint32_t  Resolved;           /*!< PHYSTS speed/duplex bits of the current link */
+  uint32_t  PhystsLatch;        /*!< PHYSTS receive error and false carrier latches, clear on read */
+  uint32_t  PreambleSuppressed; /*!< Frames to this PHY are sent without preamble */
+  uint16_t  Reg[32];
+  uint32_t  MmdDevAd;           /*!< MMDACR device address of the last access setup */
+  uint32_t  MmdFunction;        /*!< MMDACR function of the last access setup */
+  uint32_t  MmdAddr;            /*!< Current extended register address */
+  uint16_t  Mmd[DP83822_SIM_MMD_NB][DP83822_SIM_MMD_SIZE];
+  uint64_t  ResetDoneNs;        /*!< 0 when no reset is in progress */
+  uint64_t  LinkUpAtNs;         /*!< 0 when no link up is scheduled */
+  uint64_t  LinkDownAtNs;       /*!< 0 when no link loss detection is pending */
+  uint64_t  LinkDownNs;         /*!< Time the link last dropped */
+  uint64_t  BistStartNs;        /*!< Time the BIST packet generator was enabled */
+  uint64_t  BistErrors;         /*!< BIST errored bytes already moved to BICSR1 */
+  uint64_t  TdrDoneNs;          /*!< 0 when no cable diagnostic is running */
+  uint32_t  EeeActive;          /*!< EEE resolved on the current link */
+  uint64_t  LpiBaseNs;          /*!< Start of the traffic pattern */
+  uint64_t  LpiReadNs;          /*!< Time PCS status 1 was last read */
+} dp83822_SimPhy_t;
+
+typedef struct
+{
+  dp83822_SimPhy_t   Phy[32];
+  uint64_t           NowNs;
+  uint64_t           BusNs;        /*!< Bus time since DP83822_SIM_ResetCost() */
+  uint32_t           MdcHz;
+  uint32_t           FrameClocks;
+  uint32_t           ReadErrors;   /*!< Number of upcoming reads to fail */
+  dp83822_SimCost_t  Cost;
+} dp83822_Sim_t;
+
+typedef struct
+{
+  const char        *Name;
+  int32_t            Status;       /*!< Return value of the measured call */
+  dp83822_SimCost_t  Cost;
+} dp83822_SimBench_t;
+
+/* Exported variables --------------------------------------------------------*/
+extern dp83822_Sim_t DP83822_Sim;
+
+/* Exported functions --------------------------------------------------------*/
+void DP83822_SIM_Init(void);
+dp83822_SimPhy_t *DP83822_SIM_AddPhy(uint32_t Addr);
+void DP83822_SIM_SetCable(uint32_t Addr, uint32_t Connected);
+void DP83822_SIM_Advance(uint32_t Ms);
+void DP83822_SIM_InjectReadErrors(uint32_t Count);
+uint32_t DP83822_SIM_IsITAsserted(uint32_t Addr);
+void DP83822_SIM_AddErrors(uint32_t Addr, uint32_t RxErrors, uint32_t FalseCarrier);
+uint32_t DP83822_SIM_SendFrame(uint32_t Addr, const uint8_t *pFrame, uint32_t Len);
+uint16_t *DP83822_SIM_ExtReg(uint32_t Addr, uint32_t DevAd, uint32_t RegAddr);
+void DP83822_SIM_GetIOCtx(dp83822_IOCtx_t *ioctx, uint32_t Batch);
+void DP83822_SIM_ResetCost(void);
+void DP83822_SIM_GetCost(dp83822_SimCost_t *pCost);
+uint32_t DP83822_SIM_Benchmark(uint32_t Flags, dp83822_SimBench_t *pResult, uint32_t MaxCount);
+int32_t DP83822_SIM_MeasureLinkUp(uint32_t PartnerAbility, uint32_t FastStart, uint32_t FastTimers, uint32_t *pLinkUpMs);
+int32_t DP83822_SIM_MeasureLinkDown(uint32_t Criteria, uint32_t PollMs, uint32_t *pDetectUs, uint32_t *pNotifyUs);
+int32_t DP83822_SIM_MeasureDebounce(uint32_t UpMs, uint32_t DownMs, uint32_t FlapLimit, uint32_t HoldDownMs,
+                                    uint32_t Flaps, uint32_t FlapPeriodMs, uint32_t *pRaw, uint32_t *pReported);
+int32_t DP83822_SIM_MeasureSched(uint32_t Ports, uint32_t MinInterval, uint32_t MaxInterval, uint32_t RunMs,
+                                 dp83822_SchedStats_t *pStats);
+
+int32_t DP83822_SIM_ReadReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t *pRegVal);
+int32_t DP83822_SIM_WriteReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal);
+int32_t DP83822_SIM_GetTick(void);
+int32_t DP83822_SIM_ReadBatch(uint32_t DevAddr, dp83822_RegOp_t *pOps, uint32_t Count);
+int32_t DP83822_SIM_WriteBatch(uint32_t DevAddr, const dp83822_RegOp_t *pOps, uint32_t Count);
+int32_t DP83822_SIM_SetPreamble(uint32_t DevAddr, uint32_t Suppress);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DP83822_SIM_H */
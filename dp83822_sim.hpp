@@ -0,0 +1,146 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_sim.hpp
+  * @author  Knut A. Korneliussen
+  * @brief   Simulated MDIO bus IO policy for the C++ DP83822 driver variant
+  *          and a side-by-side benchmark of the C and C++ drivers.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. Header-only, link with dp83822.c and
+  * dp83822_sim.c built as C.
+  *
+  ******************************************************************************
+  */
+
+#ifndef DP83822_SIM_HPP
+#define DP83822_SIM_HPP
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <dp83822.hpp>
+#include <dp83822_sim.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define DP83822_SIM_COMPARE_MAX           8U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  const char        *Name;
+  int32_t            StatusC;      /*!< Return value of the C driver call */
+  int32_t            StatusCpp;    /*!< Return value of the C++ driver call */
+  dp83822_SimCost_t  CostC;        /*!< MDIO cost of one C driver call */
+  dp83822_SimCost_t  CostCpp;      /*!< MDIO cost of one C++ driver call */
+  uint32_t           NsC;          /*!< Host time per C driver call, simulator included */
+  uint32_t           NsCpp;        /*!< Host time per C++ driver call, simulator included */
+} dp83822_SimCompare_t;
+
+namespace dp83822
+{
+
+/* IO policy calling the simulator directly, no function pointers */
+struct SimIO
+{
+  static int32_t ReadReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t *pRegVal)
+  {
+    return DP83822_SIM_ReadReg(DevAddr, RegAddr, pRegVal);
+  }
+  static int32_t WriteReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal)
+  {
+    return DP83822_SIM_WriteReg(DevAddr, RegAddr, RegVal);
+  }
+  static int32_t GetTick(void)
+  {
+    return DP83822_SIM_GetTick();
+  }
+};
+
+} /* namespace dp83822 */
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Run the same calls through the C driver (sequential IO context,
+  *         no shadow, full preamble) and the C++ driver, each on its own PHY
+  *         of a fresh simulated bus, and report MDIO cost and host time per
+  *         call. The MDIO columns must match, the host time shows the cost
+  *         of the indirect calls and run-time decode on this machine.
+  * @param  Iterations: calls per measured entry, at least 1
+  * @param  pResult: array to hold one entry per measured call
+  * @param  MaxCount: size of pResult, DP83822_SIM_COMPARE_MAX covers all calls
+  * @retval Number of entries filled in
+  */
+inline uint32_t DP83822_SIM_CompareCpp(uint32_t Iterations, dp83822_SimCompare_t *pResult, uint32_t MaxCount)
+{
+  static dp83822_Object_t obj;
+  static dp83822::Driver<dp83822::SimIO> drv;
+  dp83822_IOCtx_t io;
+  dp83822_Status_t status;
+  uint32_t count = 0, i;
+
+  if(Iterations == 0)
+    Iterations = 1;
+
+#define DP83822_SIM_COMPARE_RUN(call, st, cost, ns)                                       \
+  do                                                                                      \
+  {                                                                                       \
+    std::chrono::steady_clock::time_point t0;                                             \
+    DP83822_SIM_ResetCost();                                                              \
+    t0 = std::chrono::steady_clock::now();                                                \
+    for(i = 0; i < n; i++)                                                                \
+      (st) = (call);                                                                      \
+    (ns) = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(   \
+             std::chrono::steady_clock::now() - t0).count() / n);                         \
+    DP83822_SIM_GetCost(&(cost));                                                         \
+    (cost).Reads /= n; (cost).Writes /= n; (cost).Jobs /= n; (cost).BusUs /= n;           \
+  } while(0)
+
+#define DP83822_SIM_COMPARE(name, count_, ccall, cppcall)                                 \
+  do                                                                                      \
+  {                                                                                       \
+    uint32_t n = (count_);                                                                \
+    if(count < MaxCount)                                                                  \
+    {                                                                                     \
+      pResult[count].Name = (name);                                                       \
+      DP83822_SIM_COMPARE_RUN(ccall, pResult[count].StatusC, pResult[count].CostC,        \
+                              pResult[count].NsC);                                        \
+      DP83822_SIM_COMPARE_RUN(cppcall, pResult[count].StatusCpp, pResult[count].CostCpp,  \
+                              pResult[count].NsCpp);                                      \
+      count++;                                                                            \
+    }                                                                                     \
+  } while(0)
+
+  /* Both drivers talk to their own PHY on the same simulated bus */
+  DP83822_SIM_Init();
+  DP83822_SIM_AddPhy(1);
+  DP83822_SIM_AddPhy(2);
+  DP83822_SIM_SetCable(1, 1);
+  DP83822_SIM_SetCable(2, 1);
+
+  /* Plain ReadReg/WriteReg on both sides: no batching, no preamble suppression */
+  DP83822_SIM_GetIOCtx(&io, 0);
+  io.SetPreamble = NULL;
+  memset(&obj, 0, sizeof(obj));
+  DP83822_RegisterBusIO(&obj, &io);
+  obj.AddrHint = 1;
+  drv = dp83822::Driver<dp83822::SimIO>();
+  drv.AddrHint = 2;
+
+  DP83822_SIM_COMPARE("Init", 1U, DP83822_Init(&obj), drv.Init());
+  DP83822_SIM_COMPARE("GetLinkState", Iterations, DP83822_GetLinkState(&obj), drv.GetLinkState());
+  DP83822_SIM_COMPARE("GetStatus", Iterations, DP83822_GetStatus(&obj, &status), drv.GetStatus(&status));
+  DP83822_SIM_COMPARE("SetLinkState", Iterations, DP83822_SetLinkState(&obj, DP83822_STATUS_100MBITS_FULLDUPLEX),
+                      drv.SetLinkState(DP83822_STATUS_100MBITS_FULLDUPLEX));
+  DP83822_SIM_COMPARE("StartAutoNego", Iterations, DP83822_StartAutoNego(&obj), drv.StartAutoNego());
+  DP83822_SIM_COMPARE("EnableLoopbackMode", Iterations, DP83822_EnableLoopbackMode(&obj), drv.EnableLoopbackMode());
+  DP83822_SIM_COMPARE("DisableLoopbackMode", Iterations, DP83822_DisableLoopbackMode(&obj), drv.DisableLoopbackMode());
+  DP83822_SIM_COMPARE("DeInit", 1U, DP83822_DeInit(&obj), drv.DeInit());
+
+#undef DP83822_SIM_COMPARE
+#undef DP83822_SIM_COMPARE_RUN
+
+  return count;
+}
+
+#endif /* DP83822_SIM_HPP */
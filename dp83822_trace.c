@@ -0,0 +1,699 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_trace.c
+  * @author  Knut A. Korneliussen
+  * @brief   MDIO trace recorder and replay IO backend for the DP83822 PHY
+  *          driver. The recorder sits between the driver and its IO context
+  *          and appends every register access and GetTick call to a compact
+  *          binary trace in a caller buffer. The replay backend serves the
+  *          driver from such a trace, so a field capture of a slow init or a
+  *          link flap runs deterministically on a host.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. Trace format: a sequence of records,
+  * accesses take 4 bytes, ticks 2 bytes for deltas below 128 ms.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <dp83822_trace.h>
+
+/* Exported variables --------------------------------------------------------*/
+dp83822_Trace_t DP83822_Trace;
+
+/* Private function prototypes -----------------------------------------------*/
+static void DP83822_TRACE_PutAccess(uint8_t Op, uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal, int32_t Status);
+static void DP83822_TRACE_PutTick(uint8_t Op, uint32_t Tick);
+static void DP83822_TRACE_PutBatch(uint32_t Count);
+static void DP83822_TRACE_Flush(void);
+static void DP83822_TRACE_Emit(const uint8_t *pData, uint32_t Size);
+static void DP83822_TRACE_EmitVarint(uint8_t Op, uint32_t Value);
+static void DP83822_TRACE_Stamp(void);
+static uint32_t DP83822_TRACE_Varint(const dp83822_TraceCursor_t *pCursor, uint32_t *pValue);
+static int32_t DP83822_TRACE_Peek(dp83822_TraceCursor_t *pNext, dp83822_TraceRec_t *pRec);
+static int32_t DP83822_TRACE_ReplayBatch(uint8_t Op, uint32_t DevAddr, const dp83822_RegOp_t *pOps, dp83822_RegOp_t *pOut, uint32_t Count);
+
+/**
+  * @brief  Start recording. pShim receives the callbacks of pTarget with
+  *         ReadReg/WriteReg/GetTick (and ReadBatch/WriteBatch if pTarget has
+  *         them) routed through the recorder, register pShim with the driver.
+  *         A polling loop that reads the same value every pass is stored as
+  *         one repeat record. Recording stops at the first record that does
+  *         not fit, so the trace is always a consistent prefix.
+  * @param  pBuf: buffer to hold the trace
+  * @param  Size: size of pBuf in bytes
+  * @param  Flags: DP83822_TRACE_xxx record flags
+  * @param  pTarget: IO context talking to the real bus
+  * @param  pShim: IO context to fill with the recording callbacks
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if a trace is already active or pTarget
+  *         misses a mandatory function
+  */
+int32_t DP83822_TRACE_StartRecord(uint8_t *pBuf, uint32_t Size, uint32_t Flags,
+                                  const dp83822_IOCtx_t *pTarget, dp83822_IOCtx_t *pShim)
+{
+  if(DP83822_Trace.Mode == DP83822_TRACE_MODE_RECORD ||
+     !pTarget->ReadReg || !pTarget->WriteReg || !pTarget->GetTick)
+    return DP83822_STATUS_ERROR;
+
+  memset(&DP83822_Trace, 0, sizeof(DP83822_Trace));
+  DP83822_Trace.Mode   = DP83822_TRACE_MODE_RECORD;
+  DP83822_Trace.Flags  = Flags;
+  DP83822_Trace.pBuf   = pBuf;
+  DP83822_Trace.Size   = Size;
+  DP83822_Trace.Target = *pTarget;
+
+  *pShim = *pTarget;
+  pShim->ReadReg  = DP83822_TRACE_ReadReg;
+  pShim->WriteReg = DP83822_TRACE_WriteReg;
+  pShim->GetTick  = DP83822_TRACE_GetTick;
+  pShim->ReadBatch  = pTarget->ReadBatch ? DP83822_TRACE_ReadBatch : NULL;
+  pShim->WriteBatch = pTarget->WriteBatch ? DP83822_TRACE_WriteBatch : NULL;
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Stop recording and write out the pending repeat.
+  * @retval Trace length in bytes
+  */
+uint32_t DP83822_TRACE_StopRecord(void)
+{
+  if(DP83822_Trace.Mode == DP83822_TRACE_MODE_RECORD)
+  {
+    DP83822_TRACE_Flush();
+    DP83822_Trace.Mode = DP83822_TRACE_MODE_IDLE;
+  }
+  return DP83822_Trace.Len;
+}
+
+/**
+  * @brief  Position a cursor at the start of a trace.
+  */
+void DP83822_TRACE_InitCursor(dp83822_TraceCursor_t *pCursor, const uint8_t *pTrace, uint32_t Len)
+{
+  memset(pCursor, 0, sizeof(*pCursor));
+  pCursor->pTrace = pTrace;
+  pCursor->Len    = Len;
+}
+
+/**
+  * @brief  Decode the next record of a trace, repeats are expanded into
+  *         the access and tick records they stand for.
+  * @param  pCursor: cursor set up by DP83822_TRACE_InitCursor()
+  * @param  pRec: pointer to hold the record
+  * @retval DP83822_STATUS_OK if pRec holds a record
+  *         DP83822_STATUS_ERROR at the end of the trace, or if the record
+  *         is truncated or malformed
+  */
+int32_t DP83822_TRACE_Next(dp83822_TraceCursor_t *pCursor, dp83822_TraceRec_t *pRec)
+{
+  const uint8_t *p;
+  uint32_t value, size;
+
+  /* Repeats alternate the access and its tick, access first */
+  if(pCursor->RepLeft)
+  {
+    if((pCursor->RepLeft & 1U) == 0)
+    {
+      *pRec = pCursor->Pattern;
+    }
+    else
+    {
+      pCursor->Now += pCursor->PatternDelta;
+      pRec->Op   = DP83822_TRACE_OP_TICK;
+      pRec->Addr = 0;
+      pRec->Reg  = 0;
+      pRec->Fail = 0;
+      pRec->Val  = pCursor->Now;
+    }
+    pCursor->RepLeft--;
+    return DP83822_STATUS_OK;
+  }
+
+  if(pCursor->Pos >= pCursor->Len)
+    return DP83822_STATUS_ERROR;
+
+  p = &pCursor->pTrace[pCursor->Pos];
+  pRec->Op = (uint8_t)(p[0] & DP83822_TRACE_OP_MASK);
+
+  switch(pRec->Op)
+  {
+    case DP83822_TRACE_OP_READ:
+    case DP83822_TRACE_OP_WRITE:
+      if(pCursor->Pos + DP83822_TRACE_ACCESS_SIZE > pCursor->Len)
+        return DP83822_STATUS_ERROR;
+      pRec->Reg  = (uint8_t)(p[0] & DP83822_TRACE_REG_MASK);
+      pRec->Addr = (uint8_t)(p[1] & DP83822_TRACE_ADDR_MASK);
+      pRec->Fail = (uint8_t)((p[1] & DP83822_TRACE_FAIL) != 0);
+      pRec->Val  = p[2] | ((uint32_t)p[3] << 8);
+      pCursor->Pos += DP83822_TRACE_ACCESS_SIZE;
+      pCursor->Last = *pRec;
+      pCursor->LastIsAccess = 1;
+      return DP83822_STATUS_OK;
+
+    case DP83822_TRACE_OP_TICK:
+    case DP83822_TRACE_OP_STAMP:
+      size = DP83822_TRACE_Varint(pCursor, &value);
+      if(size == 0)
+        return DP83822_STATUS_ERROR;
+      pCursor->Pos += size;
+      pCursor->Now += value;
+      if(pRec->Op == DP83822_TRACE_OP_TICK && pCursor->LastIsAccess)
+      {
+        pCursor->Pattern      = pCursor->Last;
+        pCursor->PatternDelta = value;
+      }
+      pCursor->LastIsAccess = 0;
+      pRec->Addr = 0;
+      pRec->Reg  = 0;
+      pRec->Fail = 0;
+      pRec->Val  = pCursor->Now;
+      return DP83822_STATUS_OK;
+
+    case DP83822_TRACE_OP_BATCH:
+      size = DP83822_TRACE_Varint(pCursor, &value);
+      if(size == 0 || value == 0)
+        return DP83822_STATUS_ERROR;
+      pCursor->Pos += size;
+      pCursor->LastIsAccess = 0;
+      pRec->Addr = 0;
+      pRec->Reg  = 0;
+      pRec->Fail = 0;
+      pRec->Val  = value;
+      return DP83822_STATUS_OK;
+
+    case DP83822_TRACE_OP_REPEAT:
+      size = DP83822_TRACE_Varint(pCursor, &value);
+      if(size == 0 || value == 0 || value > 0x7FFFFFFFU)
+        return DP83822_STATUS_ERROR;
+      pCursor->Pos += size;
+      pCursor->RepLeft = 2U * value;
+      return DP83822_TRACE_Next(pCursor, pRec);
+
+    default:
+      return DP83822_STATUS_ERROR;
+  }
+}
+
+/**
+  * @brief  Start replaying a recorded trace. pIO receives ReadReg/WriteReg/
+  *         GetTick serving the driver from the trace, register it with the
+  *         driver in place of the bus. Reads return the recorded values and
+  *         status, writes are checked against the recorded ones. An access
+  *         that does not match the next record counts as a mismatch and
+  *         fails, the driver has diverged from the capture. pIO has the
+  *         ReadBatch/WriteBatch callbacks if the trace holds batch jobs, so
+  *         the driver takes the same path as when it was recorded.
+  * @param  pTrace: trace recorded by DP83822_TRACE_StartRecord()
+  * @param  Len: trace length in bytes
+  * @param  pIO: IO context to fill with the replay callbacks
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if a recording is active
+  */
+int32_t DP83822_TRACE_StartReplay(const uint8_t *pTrace, uint32_t Len, dp83822_IOCtx_t *pIO)
+{
+  dp83822_TraceStats_t stats;
+
+  if(DP83822_Trace.Mode == DP83822_TRACE_MODE_RECORD)
+    return DP83822_STATUS_ERROR;
+
+  memset(&DP83822_Trace, 0, sizeof(DP83822_Trace));
+  DP83822_Trace.Mode = DP83822_TRACE_MODE_REPLAY;
+  DP83822_TRACE_InitCursor(&DP83822_Trace.Cursor, pTrace, Len);
+
+  memset(pIO, 0, sizeof(*pIO));
+  pIO->ReadReg  = DP83822_TRACE_ReadReg;
+  pIO->WriteReg = DP83822_TRACE_WriteReg;
+  pIO->GetTick  = DP83822_TRACE_GetTick;
+
+  if(DP83822_TRACE_Summarize(pTrace, Len, &stats) == DP83822_STATUS_OK && stats.Jobs != 0)
+  {
+    pIO->ReadBatch  = DP83822_TRACE_ReplayReadBatch;
+    pIO->WriteBatch = DP83822_TRACE_ReplayWriteBatch;
+  }
+
+  return DP83822_STATUS_OK;
+}
+
+/**
+  * @brief  Count the records of a trace without replaying it.
+  * @param  pTrace: recorded trace
+  * @param  Len: trace length in bytes
+  * @param  pStats: pointer to hold the counts and the covered time span
+  * @retval DP83822_STATUS_OK if OK
+  *         DP83822_STATUS_ERROR if the trace is truncated or malformed
+  */
+int32_t DP83822_TRACE_Summarize(const uint8_t *pTrace, uint32_t Len, dp83822_TraceStats_t *pStats)
+{
+  dp83822_TraceCursor_t cursor;
+  dp83822_TraceRec_t rec;
+  uint32_t ticked = 0;
+
+  memset(pStats, 0, sizeof(*pStats));
+  DP83822_TRACE_InitCursor(&cursor, pTrace, Len);
+
+  while(DP83822_TRACE_Next(&cursor, &rec) == DP83822_STATUS_OK)
+  {
+    switch(rec.Op)
+    {
+      case DP83822_TRACE_OP_READ:
+        pStats->Reads++;
+        pStats->Failed += rec.Fail;
+        break;
+
+      case DP83822_TRACE_OP_WRITE:
+        pStats->Writes++;
+        pStats->Failed += rec.Fail;
+        break;
+
+      case DP83822_TRACE_OP_BATCH:
+        pStats->Jobs++;
+        break;
+
+      default:
+        if(rec.Op == DP83822_TRACE_OP_TICK)
+          pStats->Ticks++;
+        if(!ticked)
+          pStats->FirstTick = rec.Val;
+        ticked = 1;
+        pStats->LastTick = rec.Val;
+        break;
+    }
+  }
+
+  return (cursor.Pos == Len && cursor.RepLeft == 0) ? DP83822_STATUS_OK : DP83822_STATUS_ERROR;
+}
+
+/**
+  * @brief  Get the counts of the active or last recording or replay. During
+  *         a replay LastTick is the recorded time reached by the driver.
+  */
+void DP83822_TRACE_GetStats(dp83822_TraceStats_t *pStats)
+{
+  *pStats = DP83822_Trace.Stats;
+  if(DP83822_Trace.Mode == DP83822_TRACE_MODE_REPLAY)
+    pStats->LastTick = DP83822_Trace.Cursor.Now;
+  else
+    pStats->LastTick = DP83822_Trace.Now;
+}
+
+/**
+  * @brief  Register read (dp83822_IOCtx_t ReadReg), recorded or replayed.
+  */
+int32_t DP83822_TRACE_ReadReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t *pRegVal)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  dp83822_TraceCursor_t next;
+  dp83822_TraceRec_t rec;
+  int32_t status;
+
+  if(trace->Mode == DP83822_TRACE_MODE_RECORD)
+  {
+    DP83822_TRACE_Stamp();
+    status = trace->Target.ReadReg(DevAddr, RegAddr, pRegVal);
+    DP83822_TRACE_PutAccess(DP83822_TRACE_OP_READ, DevAddr, RegAddr, *pRegVal, status);
+    return status;
+  }
+
+  if(DP83822_TRACE_Peek(&next, &rec) < 0 ||
+     rec.Op != DP83822_TRACE_OP_READ || rec.Addr != DevAddr || rec.Reg != RegAddr)
+  {
+    trace->Stats.Mismatches++;
+    *pRegVal = 0xFFFFU;
+    return -1;
+  }
+
+  trace->Cursor = next;
+  trace->Stats.Reads++;
+  trace->Stats.Failed += rec.Fail;
+  *pRegVal = rec.Val;
+  return rec.Fail ? -1 : 0;
+}
+
+/**
+  * @brief  Register write (dp83822_IOCtx_t WriteReg), recorded or replayed.
+  */
+int32_t DP83822_TRACE_WriteReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  dp83822_TraceCursor_t next;
+  dp83822_TraceRec_t rec;
+  int32_t status;
+
+  if(trace->Mode == DP83822_TRACE_MODE_RECORD)
+  {
+    DP83822_TRACE_Stamp();
+    status = trace->Target.WriteReg(DevAddr, RegAddr, RegVal);
+    DP83822_TRACE_PutAccess(DP83822_TRACE_OP_WRITE, DevAddr, RegAddr, RegVal, status);
+    return status;
+  }
+
+  if(DP83822_TRACE_Peek(&next, &rec) < 0 ||
+     rec.Op != DP83822_TRACE_OP_WRITE || rec.Addr != DevAddr || rec.Reg != RegAddr)
+  {
+    trace->Stats.Mismatches++;
+    return -1;
+  }
+
+  /* Same register, a different value still follows the capture */
+  if(rec.Val != (RegVal & 0xFFFFU))
+    trace->Stats.Mismatches++;
+
+  trace->Cursor = next;
+  trace->Stats.Writes++;
+  trace->Stats.Failed += rec.Fail;
+  return rec.Fail ? -1 : 0;
+}
+
+/**
+  * @brief  Tick (dp83822_IOCtx_t GetTick), recorded or replayed. A replayed
+  *         call without a tick record returns the last recorded time.
+  */
+int32_t DP83822_TRACE_GetTick(void)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  dp83822_TraceCursor_t next;
+  dp83822_TraceRec_t rec;
+  uint32_t tick;
+
+  if(trace->Mode == DP83822_TRACE_MODE_RECORD)
+  {
+    tick = (uint32_t)trace->Target.GetTick();
+    DP83822_TRACE_PutTick(DP83822_TRACE_OP_TICK, tick);
+    return (int32_t)tick;
+  }
+
+  if(DP83822_TRACE_Peek(&next, &rec) < 0 || rec.Op != DP83822_TRACE_OP_TICK)
+  {
+    trace->Stats.TickMisses++;
+    return (int32_t)trace->Cursor.Now;
+  }
+
+  trace->Cursor = next;
+  trace->Stats.Ticks++;
+  return (int32_t)rec.Val;
+}
+
+/**
+  * @brief  Batched read (dp83822_IOCtx_t ReadBatch), recorded as a batch
+  *         record followed by one read record per register.
+  */
+int32_t DP83822_TRACE_ReadBatch(uint32_t DevAddr, dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  int32_t status;
+  uint32_t i;
+
+  DP83822_TRACE_Stamp();
+  DP83822_TRACE_PutBatch(Count);
+  status = DP83822_Trace.Target.ReadBatch(DevAddr, pOps, Count);
+
+  for(i = 0; i < Count; i++)
+  {
+    DP83822_TRACE_PutAccess(DP83822_TRACE_OP_READ, DevAddr, pOps[i].RegAddr, pOps[i].RegVal, status);
+  }
+  return status;
+}
+
+/**
+  * @brief  Batched write (dp83822_IOCtx_t WriteBatch), recorded as a batch
+  *         record followed by one write record per register.
+  */
+int32_t DP83822_TRACE_WriteBatch(uint32_t DevAddr, const dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  int32_t status;
+  uint32_t i;
+
+  DP83822_TRACE_Stamp();
+  DP83822_TRACE_PutBatch(Count);
+  status = DP83822_Trace.Target.WriteBatch(DevAddr, pOps, Count);
+
+  for(i = 0; i < Count; i++)
+  {
+    DP83822_TRACE_PutAccess(DP83822_TRACE_OP_WRITE, DevAddr, pOps[i].RegAddr, pOps[i].RegVal, status);
+  }
+  return status;
+}
+
+/**
+  * @brief  Replayed batched read (dp83822_IOCtx_t ReadBatch).
+  */
+int32_t DP83822_TRACE_ReplayReadBatch(uint32_t DevAddr, dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  return DP83822_TRACE_ReplayBatch(DP83822_TRACE_OP_READ, DevAddr, pOps, pOps, Count);
+}
+
+/**
+  * @brief  Replayed batched write (dp83822_IOCtx_t WriteBatch).
+  */
+int32_t DP83822_TRACE_ReplayWriteBatch(uint32_t DevAddr, const dp83822_RegOp_t *pOps, uint32_t Count)
+{
+  return DP83822_TRACE_ReplayBatch(DP83822_TRACE_OP_WRITE, DevAddr, pOps, NULL, Count);
+}
+
+/**
+  * @brief  Record an access. An access equal to the last one, right after
+  *         the tick that followed it, is held back: if the same tick delta
+  *         follows again the pair only bumps the repeat count.
+  */
+static void DP83822_TRACE_PutAccess(uint8_t Op, uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal, int32_t Status)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  uint8_t rec[DP83822_TRACE_ACCESS_SIZE];
+
+  if(Op == DP83822_TRACE_OP_READ)
+    trace->Stats.Reads++;
+  else
+    trace->Stats.Writes++;
+  if(Status < 0)
+    trace->Stats.Failed++;
+
+  rec[0] = (uint8_t)(Op | (RegAddr & DP83822_TRACE_REG_MASK));
+  rec[1] = (uint8_t)((DevAddr & DP83822_TRACE_ADDR_MASK) | ((Status < 0) ? DP83822_TRACE_FAIL : 0U));
+  rec[2] = (uint8_t)(RegVal & 0xFFU);
+  rec[3] = (uint8_t)((RegVal >> 8) & 0xFFU);
+
+  if(!trace->HeldValid && trace->PatternValid && memcmp(rec, trace->Last, sizeof(rec)) == 0)
+  {
+    memcpy(trace->Held, rec, sizeof(rec));
+    trace->HeldValid = 1;
+    return;
+  }
+
+  DP83822_TRACE_Flush();
+  DP83822_TRACE_Emit(rec, sizeof(rec));
+  memcpy(trace->Last, rec, sizeof(rec));
+  trace->LastIsAccess = 1;
+  trace->PatternValid = 0;
+}
+
+/**
+  * @brief  Record a tick or stamp, the delta to the previous one as a
+  *         little endian base-128 varint.
+  */
+static void DP83822_TRACE_PutTick(uint8_t Op, uint32_t Tick)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  uint32_t delta = Tick - trace->Now;
+
+  if(Op == DP83822_TRACE_OP_TICK)
+    trace->Stats.Ticks++;
+  if(!trace->HasTick)
+    trace->Stats.FirstTick = Tick;
+  trace->Now     = Tick;
+  trace->HasTick = 1;
+
+  if(trace->HeldValid && Op == DP83822_TRACE_OP_TICK && delta == trace->PatternDelta)
+  {
+    trace->HeldValid = 0;
+    trace->RepCount++;
+    return;
+  }
+
+  DP83822_TRACE_Flush();
+  DP83822_TRACE_EmitVarint(Op, delta);
+  trace->PatternValid = (Op == DP83822_TRACE_OP_TICK && trace->LastIsAccess);
+  trace->PatternDelta = delta;
+  trace->LastIsAccess = 0;
+}
+
+/**
+  * @brief  Record the start of a batch job.
+  */
+static void DP83822_TRACE_PutBatch(uint32_t Count)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+
+  trace->Stats.Jobs++;
+  DP83822_TRACE_Flush();
+  DP83822_TRACE_EmitVarint(DP83822_TRACE_OP_BATCH, Count);
+  trace->LastIsAccess = 0;
+  trace->PatternValid = 0;
+}
+
+/**
+  * @brief  Write out the pending repeat count and held access.
+  */
+static void DP83822_TRACE_Flush(void)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+
+  if(trace->RepCount)
+  {
+    DP83822_TRACE_EmitVarint(DP83822_TRACE_OP_REPEAT, trace->RepCount);
+    trace->RepCount = 0;
+  }
+
+  if(trace->HeldValid)
+  {
+    trace->HeldValid = 0;
+    DP83822_TRACE_Emit(trace->Held, DP83822_TRACE_ACCESS_SIZE);
+    trace->LastIsAccess = 1;
+    trace->PatternValid = 0;
+  }
+}
+
+/**
+  * @brief  Append bytes to the trace, or stop recording if they do not fit.
+  */
+static void DP83822_TRACE_Emit(const uint8_t *pData, uint32_t Size)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+
+  if(trace->Overflow || trace->Len + Size > trace->Size)
+  {
+    trace->Overflow = 1;
+    return;
+  }
+
+  memcpy(&trace->pBuf[trace->Len], pData, Size);
+  trace->Len += Size;
+}
+
+/**
+  * @brief  Append an opcode followed by a varint.
+  */
+static void DP83822_TRACE_EmitVarint(uint8_t Op, uint32_t Value)
+{
+  uint8_t rec[DP83822_TRACE_VARINT_SIZE_MAX];
+  uint32_t size = 0;
+
+  rec[size++] = Op;
+  do
+  {
+    rec[size] = (uint8_t)(Value & 0x7FU);
+    Value >>= 7;
+    if(Value)
+      rec[size] |= 0x80U;
+    size++;
+  } while(Value);
+
+  DP83822_TRACE_Emit(rec, size);
+}
+
+/**
+  * @brief  With DP83822_TRACE_STAMP, record the time of the next access
+  *         when it moved since the last tick or stamp.
+  */
+static void DP83822_TRACE_Stamp(void)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  uint32_t tick;
+
+  if(!(trace->Flags & DP83822_TRACE_STAMP))
+    return;
+
+  tick = (uint32_t)trace->Target.GetTick();
+  if(!trace->HasTick || tick != trace->Now)
+  {
+    DP83822_TRACE_PutTick(DP83822_TRACE_OP_STAMP, tick);
+  }
+}
+
+/**
+  * @brief  Decode the varint following the opcode at the cursor.
+  * @retval Record size including the opcode, 0 if truncated
+  */
+static uint32_t DP83822_TRACE_Varint(const dp83822_TraceCursor_t *pCursor, uint32_t *pValue)
+{
+  uint32_t value = 0, shift = 0, size = 1;
+  uint8_t b;
+
+  do
+  {
+    if(pCursor->Pos + size >= pCursor->Len || shift > 28U)
+      return 0;
+    b = pCursor->pTrace[pCursor->Pos + size];
+    value |= (uint32_t)(b & 0x7FU) << shift;
+    shift += 7U;
+    size++;
+  } while(b & 0x80U);
+
+  *pValue = value;
+  return size;
+}
+
+/**
+  * @brief  Get the next record to replay into a copy of the cursor, past
+  *         the stamps before it. The copy replaces the cursor once the
+  *         record matches the driver call.
+  */
+static int32_t DP83822_TRACE_Peek(dp83822_TraceCursor_t *pNext, dp83822_TraceRec_t *pRec)
+{
+  *pNext = DP83822_Trace.Cursor;
+
+  /* Stamps only move the time */
+  while(DP83822_TRACE_Next(pNext, pRec) == DP83822_STATUS_OK)
+  {
+    if(pRec->Op != DP83822_TRACE_OP_STAMP)
+      return DP83822_STATUS_OK;
+  }
+  return DP83822_STATUS_ERROR;
+}
+
+/**
+  * @brief  Serve a batch job from a batch record and its accesses, read
+  *         values go to pOut. The cursor only moves once the whole job
+  *         matched.
+  */
+static int32_t DP83822_TRACE_ReplayBatch(uint8_t Op, uint32_t DevAddr, const dp83822_RegOp_t *pOps, dp83822_RegOp_t *pOut, uint32_t Count)
+{
+  dp83822_Trace_t *trace = &DP83822_Trace;
+  dp83822_TraceCursor_t next;
+  dp83822_TraceRec_t rec;
+  uint32_t i, fail = 0, differ = 0;
+
+  if(DP83822_TRACE_Peek(&next, &rec) < 0 || rec.Op != DP83822_TRACE_OP_BATCH || rec.Val != Count)
+  {
+    trace->Stats.Mismatches++;
+    return -1;
+  }
+
+  for(i = 0; i < Count; i++)
+  {
+    if(DP83822_TRACE_Next(&next, &rec) < 0 || rec.Op != Op || rec.Addr != DevAddr || rec.Reg != pOps[i].RegAddr)
+    {
+      trace->Stats.Mismatches++;
+      return -1;
+    }
+    if(pOut)
+      pOut[i].RegVal = rec.Val;
+    else if(rec.Val != (pOps[i].RegVal & 0xFFFFU))
+      differ = 1;
+    fail |= rec.Fail;
+  }
+
+  trace->Cursor = next;
+  trace->Stats.Jobs++;
+  trace->Stats.Mismatches += differ;
+  trace->Stats.Failed += fail ? Count : 0;
+  if(Op == DP83822_TRACE_OP_READ)
+    trace->Stats.Reads += Count;
+  else
+    trace->Stats.Writes += Count;
+
+  return fail ? -1 : 0;
+}
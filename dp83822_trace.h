@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    dp83822_trace.h
+  * @author  Knut A. Korneliussen
+  * @brief   MDIO trace recorder and replay IO backend for the DP83822 PHY
+  *          driver.
+  ******************************************************************************
+  * @attention
+  *
+  * This software is provided AS-IS. The recorder wraps any dp83822_IOCtx_t and
+  * runs on target, the replay backend feeds a recorded trace to the driver on
+  * any hosted C99 toolchain.
+  *
+  ******************************************************************************
+  */
+
+#ifndef DP83822_TRACE_H
+#define DP83822_TRACE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include <dp83822.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Record opcodes, bits [7:5] of the first byte of each record */
+#define DP83822_TRACE_OP_READ         ((uint8_t)0x00U)  /*!< 4 bytes: op|reg, fail|addr, value LE */
+#define DP83822_TRACE_OP_WRITE        ((uint8_t)0x20U)  /*!< 4 bytes, same layout */
+#define DP83822_TRACE_OP_TICK         ((uint8_t)0x40U)  /*!< op + varint tick delta, a driver GetTick call */
+#define DP83822_TRACE_OP_STAMP        ((uint8_t)0x60U)  /*!< op + varint tick delta, time of the next access */
+#define DP83822_TRACE_OP_REPEAT       ((uint8_t)0x80U)  /*!< op + varint N, last access and tick occur N more times */
+#define DP83822_TRACE_OP_BATCH        ((uint8_t)0xA0U)  /*!< op + varint N, the next N accesses were one batch job */
+#define DP83822_TRACE_OP_MASK         ((uint8_t)0xE0U)
+#define DP83822_TRACE_REG_MASK        ((uint8_t)0x1FU)
+#define DP83822_TRACE_FAIL            ((uint8_t)0x80U)  /*!< Second byte: the IO call returned < 0 */
+#define DP83822_TRACE_ADDR_MASK       ((uint8_t)0x1FU)
+
+#define DP83822_TRACE_ACCESS_SIZE     4U
+#define DP83822_TRACE_VARINT_SIZE_MAX 6U                 /*!< op + 5-byte varint */
+
+/* DP83822_TRACE_StartRecord() flags */
+#define DP83822_TRACE_STAMP           ((uint32_t)0x0001U) /*!< Timestamp accesses, one extra GetTick each */
+
+/* Trace modes */
+#define DP83822_TRACE_MODE_IDLE       ((uint32_t)0U)
+#define DP83822_TRACE_MODE_RECORD     ((uint32_t)1U)
+#define DP83822_TRACE_MODE_REPLAY     ((uint32_t)2U)
+
+/* Exported types ------------------------------------------------------------*/
+/* One decoded record */
+typedef struct
+{
+  uint8_t   Op;           /*!< DP83822_TRACE_OP_xxx, never DP83822_TRACE_OP_REPEAT */
+  uint8_t   Addr;
+  uint8_t   Reg;
+  uint8_t   Fail;
+  uint32_t  Val;          /*!< Register value, absolute tick or batch size */
+} dp83822_TraceRec_t;
+
+/* Position in a trace, expands the repeat records */
+typedef struct
+{
+  const uint8_t        *pTrace;
+  uint32_t              Len;
+  uint32_t              Pos;
+  uint32_t              Now;          /*!< Tick of the last tick or stamp record */
+  uint32_t              RepLeft;      /*!< Records still to produce from a repeat */
+  uint32_t              LastDelta;    /*!< Delta of the last tick record */
+  uint32_t              LastIsAccess; /*!< Last record was an access, Last holds it */
+  dp83822_TraceRec_t    Last;         /*!< Last access record */
+  dp83822_TraceRec_t    Pattern;      /*!< Access repeated by the current repeat */
+  uint32_t              PatternDelta;
+} dp83822_TraceCursor_t;
+
+typedef struct
+{
+  uint32_t  Reads;          /*!< Read records */
+  uint32_t  Writes;         /*!< Write records */
+  uint32_t  Ticks;          /*!< GetTick records */
+  uint32_t  Jobs;           /*!< ReadBatch/WriteBatch jobs */
+  uint32_t  Failed;         /*!< Accesses that returned an error */
+  uint32_t  FirstTick;      /*!< Time of the first tick or stamp record */
+  uint32_t  LastTick;       /*!< Time of the last tick or stamp record */
+  uint32_t  Mismatches;     /*!< Replay: driver access differing from the trace */
+  uint32_t  TickMisses;     /*!< Replay: GetTick calls without a tick record */
+} dp83822_TraceStats_t;
+
+typedef struct
+{
+  uint32_t              Mode;         /*!< DP83822_TRACE_MODE_xxx */
+  uint32_t              Flags;        /*!< DP83822_TRACE_xxx record flags */
+  dp83822_TraceStats_t  Stats;
+
+  /* Recording */
+  dp83822_IOCtx_t       Target;       /*!< Wrapped IO context */
+  uint8_t              *pBuf;
+  uint32_t              Size;
+  uint32_t              Len;          /*!< Bytes used */
+  uint32_t              Overflow;     /*!< A record did not fit, recording stopped */
+  uint32_t              Now;          /*!< Tick of the last tick or stamp record */
+  uint32_t              HasTick;      /*!< Now holds a recorded value */
+  uint8_t               Last[DP83822_TRACE_ACCESS_SIZE];    /*!< Last access written */
+  uint8_t               Held[DP83822_TRACE_ACCESS_SIZE];    /*!< Access equal to Last, waiting for its tick */
+  uint32_t              LastIsAccess; /*!< Last record written was an access */
+  uint32_t              HeldValid;
+  uint32_t              PatternValid; /*!< Last is followed by a tick of PatternDelta */
+  uint32_t              PatternDelta;
+  uint32_t              RepCount;     /*!< Pattern repeats not yet written */
+
+  /* Replay */
+  dp83822_TraceCursor_t Cursor;
+} dp83822_Trace_t;
+
+/* Exported variables --------------------------------------------------------*/
+extern dp83822_Trace_t DP83822_Trace;
+
+/* Exported functions --------------------------------------------------------*/
+int32_t DP83822_TRACE_StartRecord(uint8_t *pBuf, uint32_t Size, uint32_t Flags,
+                                  const dp83822_IOCtx_t *pTarget, dp83822_IOCtx_t *pShim);
+uint32_t DP83822_TRACE_StopRecord(void);
+void DP83822_TRACE_InitCursor(dp83822_TraceCursor_t *pCursor, const uint8_t *pTrace, uint32_t Len);
+int32_t DP83822_TRACE_Next(dp83822_TraceCursor_t *pCursor, dp83822_TraceRec_t *pRec);
+int32_t DP83822_TRACE_StartReplay(const uint8_t *pTrace, uint32_t Len, dp83822_IOCtx_t *pIO);
+int32_t DP83822_TRACE_Summarize(const uint8_t *pTrace, uint32_t Len, dp83822_TraceStats_t *pStats);
+void DP83822_TRACE_GetStats(dp83822_TraceStats_t *pStats);
+
+int32_t DP83822_TRACE_ReadReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t *pRegVal);
+int32_t DP83822_TRACE_WriteReg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal);
+int32_t DP83822_TRACE_GetTick(void);
+int32_t DP83822_TRACE_ReadBatch(uint32_t DevAddr, dp83822_RegOp_t *pOps, uint32_t Count);
+int32_t DP83822_TRACE_WriteBatch(uint32_t DevAddr, const dp83822_RegOp_t *pOps, uint32_t Count);
+int32_t DP83822_TRACE_ReplayReadBatch(uint32_t DevAddr, dp83822_RegOp_t *pOps, uint32_t Count);
+int32_t DP83822_TRACE_ReplayWriteBatch(uint32_t DevAddr, const dp83822_RegOp_t *pOps, uint32_t Count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DP83822_TRACE_H */